@@ -84,6 +84,7 @@ import {
 } from "project-editor/flow/components/component-types";
 
 import { DummyDataBuffer, DataBuffer } from "project-editor/build/data-buffer";
+import { compress } from "project-editor/build/lz4";
 
 import { LVGLBuild } from "project-editor/lvgl/build";
 import { ProjectEditor } from "project-editor/project-editor-interface";
@@ -1379,26 +1380,149 @@ function buildLanguages(assets: Assets, dataBuffer: DataBuffer) {
                 dataBuffer.writeString(language.languageID);
             });
 
-            dataBuffer.writeArray(
-                assets.projectStore.project.texts.resources,
-                textResource => {
-                    const translation = textResource.translations.find(
-                        translation =>
-                            translation.languageID == language.languageID
-                    );
-                    if (translation) {
-                        dataBuffer.writeString(translation.text ?? "");
-                    } else {
-                        dataBuffer.writeString("");
+            // translations are written as a section array, so that
+            // buildSectionedAssetsData can store them in its own section
+            dataBuffer.writeSectionArray(() =>
+                dataBuffer.writeArray(
+                    assets.projectStore.project.texts.resources,
+                    textResource => {
+                        const translation = textResource.translations.find(
+                            translation =>
+                                translation.languageID == language.languageID
+                        );
+                        if (translation) {
+                            dataBuffer.writeString(translation.text ?? "");
+                        } else {
+                            dataBuffer.writeString("");
+                        }
                     }
-                }
+                )
             );
         },
         8
     );
 }
 
-export async function buildGuiAssetsData(assets: Assets) {
+// ASSETS_SECTION_CORE = 0, ASSETS_SECTION_LANGUAGE = 1
+const ASSETS_SECTION_CORE = 0;
+const ASSETS_SECTION_LANGUAGE = 1;
+
+// with parallelFlowDefinitionDecompression build option core section is split
+// into independently compressed blocks of this size, so native runtime on
+// hosted targets can decompress them in parallel
+const ASSETS_CORE_BLOCK_SIZE = 64 * 1024;
+
+async function buildSectionedAssetsData(
+    assets: Assets,
+    dataBuffer: DataBuffer,
+    compressionLevel: number
+) {
+    // Everything in front of the first section array is the core section,
+    // with the section array headers cleared, stored as a run of core blocks.
+    // Each language translations list becomes a separate section which
+    // runtime decompresses on first use.
+    const coreSize =
+        dataBuffer.sections.length > 0
+            ? dataBuffer.sections[0].start
+            : dataBuffer.size;
+
+    const coreData = Buffer.alloc(coreSize);
+    dataBuffer.buffer.copy(coreData, 0, 0, coreSize);
+
+    const languageSections: { type: number; index: number; data: Buffer }[] =
+        [];
+
+    dataBuffer.sections.forEach((section, index) => {
+        coreData.writeUInt32LE(0, section.offset);
+        coreData.writeUInt32LE(0, section.offset + 4);
+
+        const data = Buffer.alloc(8 + section.end - section.start);
+        // count
+        data.writeUInt32LE(
+            dataBuffer.buffer.readUInt32LE(section.offset),
+            0
+        );
+        // items, relative to itself
+        data.writeInt32LE(section.end > section.start ? 4 : 0, 4);
+        dataBuffer.buffer.copy(data, 8, section.start, section.end);
+
+        languageSections.push({ type: ASSETS_SECTION_LANGUAGE, index, data });
+    });
+
+    const coreBlockSize = assets.projectStore.project.settings.build
+        .parallelFlowDefinitionDecompression
+        ? ASSETS_CORE_BLOCK_SIZE
+        : Math.max(coreSize, 1);
+
+    const sections: { type: number; index: number; data: Buffer }[] = [];
+    for (
+        let offset = 0;
+        offset == 0 || offset < coreSize;
+        offset += coreBlockSize
+    ) {
+        sections.push({
+            type: ASSETS_SECTION_CORE,
+            index: sections.length,
+            data: coreData.subarray(
+                offset,
+                Math.min(offset + coreBlockSize, coreSize)
+            )
+        });
+    }
+    sections.push(...languageSections);
+
+    const compressedSections = [];
+    for (const section of sections) {
+        compressedSections.push(
+            (await compress(section.data, compressionLevel)).compressedBuffer
+        );
+    }
+
+    const headerBuffer = new DataBuffer(assets.utf8Support);
+
+    // HEADER_TAG_SECTIONED = 0x7365657E
+    headerBuffer.writeUint8Array(new TextEncoder().encode("~ees"));
+    // projectMajorVersion
+    headerBuffer.writeUint8(3);
+    // projectMinorVersion
+    headerBuffer.writeUint8(0);
+    // assetsType
+    headerBuffer.writeUint8(assets.projectStore.projectTypeTraits.id);
+    // reserved
+    headerBuffer.writeUint8(0);
+    // decompressedSize (of the core section)
+    headerBuffer.writeUint32(coreSize);
+
+    // numSections
+    headerBuffer.writeUint32(sections.length);
+
+    let compressedOffset = 16 + sections.length * 20;
+    sections.forEach((section, i) => {
+        // type, reserved1
+        headerBuffer.writeUint8(section.type);
+        headerBuffer.writeUint8(0);
+        // reserved2
+        headerBuffer.writeUint16(0);
+        // index
+        headerBuffer.writeUint32(section.index);
+        // compressedOffset
+        headerBuffer.writeUint32(compressedOffset);
+        // compressedSize
+        headerBuffer.writeUint32(compressedSections[i].length);
+        // decompressedSize
+        headerBuffer.writeUint32(section.data.length);
+        compressedOffset += compressedSections[i].length;
+    });
+
+    headerBuffer.finalize();
+
+    return Buffer.concat([headerBuffer.buffer, ...compressedSections]);
+}
+
+export async function buildGuiAssetsData(
+    assets: Assets,
+    sectioned: boolean = false
+) {
     const dataBuffer = new DataBuffer(assets.utf8Support);
 
     // settings
@@ -1494,7 +1618,15 @@ export async function buildGuiAssetsData(assets: Assets) {
         "Compressed size: " + compressedSize
     );
 
-    return { uncompressedData, compressedData };
+    const sectionedData = sectioned
+        ? await buildSectionedAssetsData(
+              assets,
+              dataBuffer,
+              COMPRESSION_LEVEL_DEFAULT
+          )
+        : undefined;
+
+    return { uncompressedData, compressedData, sectionedData };
 }
 
 export async function buildAssets(
@@ -1601,10 +1733,19 @@ export async function buildAssets(
         buildAssetsData ||
         buildAssetsDataMap
     ) {
+        // generated eez-flow sources for LVGL understand sectioned assets,
+        // where each language is decompressed only when it is used
+        const lvglCompressFlowDefinition =
+            project.projectTypeTraits.isLVGL &&
+            project.settings.build.generateSourceCodeForEezFramework &&
+            project.settings.build.compressFlowDefinition;
+
         // build all assets as single data chunk
-        const { uncompressedData, compressedData } = await buildGuiAssetsData(
-            assets
-        );
+        const { uncompressedData, compressedData, sectionedData } =
+            await buildGuiAssetsData(
+                assets,
+                option != "buildAssets" && lvglCompressFlowDefinition
+            );
 
         if (option != "buildAssets") {
             if (
@@ -1613,15 +1754,10 @@ export async function buildAssets(
                     !project.projectTypeTraits.hasFlowSupport
                 )
             ) {
-                const lvglCompressFlowDefinition =
-                    project.projectTypeTraits.isLVGL &&
-                    project.settings.build.generateSourceCodeForEezFramework &&
-                    project.settings.build.compressFlowDefinition;
-
                 if (buildAssetsDecl) {
                     result.GUI_ASSETS_DECL = buildGuiAssetsDecl(
                         lvglCompressFlowDefinition
-                            ? compressedData
+                            ? sectionedData!
                             : uncompressedData
                     );
                 }
@@ -1634,7 +1770,7 @@ export async function buildAssets(
                 if (buildAssetsDef) {
                     result.GUI_ASSETS_DEF = await buildGuiAssetsDef(
                         lvglCompressFlowDefinition
-                            ? compressedData
+                            ? sectionedData!
                             : uncompressedData
                     );
                 }
@@ -16,6 +16,19 @@ export class DataBuffer {
         callback: () => void;
     }[] = [];
 
+    sectionArrayList: {
+        currentOffset: number;
+        callback: () => void;
+    }[] = [];
+
+    // Filled by finalize: each section array occupies [start, end) at the
+    // end of the buffer and only contains offsets relative to itself.
+    sections: {
+        offset: number;
+        start: number;
+        end: number;
+    }[] = [];
+
     constructor(public utf8Support: boolean) {}
 
     writeInt8(value: number) {
@@ -153,6 +166,19 @@ export class DataBuffer {
         });
     }
 
+    writeSectionArray(callback: () => void) {
+        if (this.currentOffset % 4) {
+            throw "invalid offset 14";
+        }
+        const currentOffset = this.currentOffset;
+        this.writeUint32(0);
+        this.writeUint32(0);
+        this.sectionArrayList.push({
+            currentOffset,
+            callback
+        });
+    }
+
     writeNumberArray<T>(arr: T[], callback: (item: T, i: number) => void) {
         if (this.currentOffset % 4) {
             throw "invalid offset 12";
@@ -244,6 +270,21 @@ export class DataBuffer {
 
         this.finalizeObjectList();
 
+        for (let i = 0; i < this.sectionArrayList.length; i++) {
+            const start = this.currentOffset;
+            this.currentOffset = this.sectionArrayList[i].currentOffset;
+            this.sectionArrayList[i].callback();
+            this.currentOffset = start;
+
+            this.finalizeObjectList();
+
+            this.sections.push({
+                offset: this.sectionArrayList[i].currentOffset,
+                start,
+                end: this.currentOffset
+            });
+        }
+
         const buffer = Buffer.alloc(this.size);
         this.buffer.copy(buffer, 0, 0, this.size);
         this.buffer = buffer;
@@ -316,6 +357,10 @@ export class DummyDataBuffer {
         callback();
     }
 
+    writeSectionArray(callback: () => void) {
+        callback();
+    }
+
     writeNumberArray<T>(arr: T[], callback: (item: T, i: number) => void) {
         arr.forEach((item, i) => callback(item, i));
     }
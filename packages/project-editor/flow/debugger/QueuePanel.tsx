@@ -17,16 +17,30 @@ export const QueuePanel = observer(
         render() {
             const memTotal = this.props.runtime.totalMemory;
             const memAlloc = memTotal - this.props.runtime.freeMemory;
+            const queueStats = this.props.runtime.queueStats;
             return (
                 <div className="EezStudio_DebuggerPanel">
                     <Panel
                         id="project-editor/debugger/queue"
                         title={
-                            this.props.runtime.totalMemory != 0
+                            (this.props.runtime.totalMemory != 0
                                 ? `Memory usage: ${memAlloc} of ${memTotal} (${Math.round(
                                       (memAlloc * 100) / memTotal
                                   )}%)`
-                                : ""
+                                : "") +
+                            (queueStats
+                                ? `${
+                                      this.props.runtime.totalMemory != 0
+                                          ? ", "
+                                          : ""
+                                  }Queue peak: ${
+                                      queueStats.highWaterMark
+                                  } of ${
+                                      queueStats.capacity
+                                  }, avg: ${queueStats.averageDepth.toFixed(
+                                      1
+                                  )}`
+                                : "")
                         }
                         buttons={
                             this.props.runtime instanceof DebugInfoRuntime
@@ -386,7 +386,7 @@ function buildExpressionNode(
             }
         }
 
-        if (functionName == "Crypto.sha256") {
+        if (functionName.startsWith("Crypto.sha256")) {
             assets.isUsingCrypyoSha256 = true;
         }
 
@@ -13,6 +13,35 @@ function roundN(value: number, decimals: number) {
     return Number(Math.round(Number(value + "e" + decimals)) + "e-" + decimals);
 }
 
+// operations implemented only by the eez-framework sources generated for
+// LVGL projects, simulator runtimes don't know about them
+function isEezFrameworkProject(projectStore: ProjectStore) {
+    return (
+        projectStore.projectTypeTraits.isLVGL &&
+        projectStore.project.settings.build.generateSourceCodeForEezFramework
+    );
+}
+
+let crc32Table: Uint32Array | undefined;
+
+function crc32(data: Uint8Array) {
+    if (!crc32Table) {
+        crc32Table = new Uint32Array(256);
+        for (let i = 0; i < 256; i++) {
+            let crc = i;
+            for (let j = 0; j < 8; j++) {
+                crc = crc & 1 ? (crc >>> 1) ^ 0xedb88320 : crc >>> 1;
+            }
+            crc32Table[i] = crc;
+        }
+    }
+    let crc = 0xffffffff;
+    for (let i = 0; i < data.length; i++) {
+        crc = (crc >>> 8) ^ crc32Table[(crc ^ data[i]) & 0xff];
+    }
+    return (crc ^ 0xffffffff) >>> 0;
+}
+
 export const binaryOperators: {
     [operator: string]: {
         operationIndex: number;
@@ -632,6 +661,48 @@ export const builtInFunctions: {
         }
     },
 
+    "Crypto.sha256Init": {
+        operationIndex: 90,
+        arity: 0,
+        args: [],
+        eval: (
+            expressionContext: IExpressionContext | undefined,
+            ...args: any[]
+        ) => Buffer.alloc(0),
+        getValueType: (...args: ValueType[]) => {
+            return "blob";
+        },
+        enabled: isEezFrameworkProject
+    },
+
+    "Crypto.sha256Update": {
+        operationIndex: 91,
+        arity: 2,
+        args: ["context", "string_or_blob"],
+        eval: (
+            expressionContext: IExpressionContext | undefined,
+            ...args: any[]
+        ) => Buffer.concat([args[0], Buffer.from(args[1])]),
+        getValueType: (...args: ValueType[]) => {
+            return "blob";
+        },
+        enabled: isEezFrameworkProject
+    },
+
+    "Crypto.sha256Final": {
+        operationIndex: 92,
+        arity: 1,
+        args: ["context"],
+        eval: (
+            expressionContext: IExpressionContext | undefined,
+            ...args: any[]
+        ) => sha256(args[0]),
+        getValueType: (...args: ValueType[]) => {
+            return "blob";
+        },
+        enabled: isEezFrameworkProject
+    },
+
     "Date.now": {
         operationIndex: 34,
         arity: 0,
@@ -793,6 +864,30 @@ export const builtInFunctions: {
             return "date";
         }
     },
+    "Date.break": {
+        operationIndex: 88,
+        arity: 1,
+        args: ["date"],
+        eval: (
+            expressionContext: IExpressionContext | undefined,
+            ...args: any[]
+        ) => {
+            const date = new Date(args[0]);
+            return [
+                date.getFullYear(),
+                date.getMonth() + 1,
+                date.getDate(),
+                date.getHours(),
+                date.getMinutes(),
+                date.getSeconds(),
+                date.getMilliseconds()
+            ];
+        },
+        getValueType: (...args: ValueType[]) => {
+            return "array:integer";
+        },
+        enabled: isEezFrameworkProject
+    },
 
     "Math.sin": {
         operationIndex: 37,
@@ -1265,6 +1360,20 @@ export const builtInFunctions: {
         }
     },
 
+    "Blob.crc32": {
+        operationIndex: 93,
+        arity: 1,
+        args: ["string_or_blob"],
+        eval: (
+            expressionContext: IExpressionContext | undefined,
+            ...args: any[]
+        ) => crc32(Buffer.from(args[0])),
+        getValueType: (...args: ValueType[]) => {
+            return "integer";
+        },
+        enabled: isEezFrameworkProject
+    },
+
     "JSON.get": {
         operationIndex: 76,
         arity: 2,
@@ -1279,6 +1388,20 @@ export const builtInFunctions: {
         enabled: projectStore => projectStore.projectTypeTraits.isDashboard
     },
 
+    "JSON.parse": {
+        operationIndex: 89,
+        arity: 1,
+        args: ["text"],
+        eval: (
+            expressionContext: IExpressionContext | undefined,
+            ...args: any[]
+        ) => JSON.parse(args[0]),
+        getValueType: (...args: ValueType[]) => {
+            return "json";
+        },
+        enabled: isEezFrameworkProject
+    },
+
     "JSON.clone": {
         operationIndex: 77,
         arity: 1,
@@ -68,7 +68,9 @@ export enum MessagesToDebugger {
     MESSAGE_TO_DEBUGGER_PAGE_CHANGED, // PAGE_ID
 
     MESSAGE_TO_DEBUGGER_COMPONENT_EXECUTION_STATE_CHANGED, // FLOW_STATE_INDEX, COMPONENT_INDEX, STATE
-    MESSAGE_TO_DEBUGGER_COMPONENT_ASYNC_STATE_CHANGED // FLOW_STATE_INDEX, COMPONENT_INDEX, STATE
+    MESSAGE_TO_DEBUGGER_COMPONENT_ASYNC_STATE_CHANGED, // FLOW_STATE_INDEX, COMPONENT_INDEX, STATE
+
+    MESSAGE_TO_DEBUGGER_QUEUE_STATS // SIZE, CAPACITY, HIGH_WATER_MARK, AVERAGE_DEPTH, OVERFLOWS_AVOIDED
 }
 
 enum MessagesFromDebugger {
@@ -270,6 +272,9 @@ export class RemoteRuntime extends RuntimeBase {
     cleanup() {
         this.debuggerValues.clear();
         this.flowStateMap.clear();
+        runInAction(() => {
+            this.queueStats = undefined;
+        });
     }
 
     async doStopRuntime(notifyUser: boolean) {
@@ -1608,6 +1613,20 @@ export abstract class DebuggerConnectionBase {
                         );
                     }
                     break;
+
+                case MessagesToDebugger.MESSAGE_TO_DEBUGGER_QUEUE_STATS:
+                    {
+                        runInAction(() => {
+                            this.runtime.queueStats = {
+                                size: parseInt(messageParameters[1]),
+                                capacity: parseInt(messageParameters[2]),
+                                highWaterMark: parseInt(messageParameters[3]),
+                                averageDepth: parseFloat(messageParameters[4]),
+                                overflowsAvoided: parseInt(messageParameters[5])
+                            };
+                        });
+                    }
+                    break;
             }
         }
     }
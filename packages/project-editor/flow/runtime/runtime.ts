@@ -113,6 +113,16 @@ export abstract class RuntimeBase {
     freeMemory: number = 0;
     totalMemory: number = 0;
 
+    queueStats:
+        | {
+              size: number;
+              capacity: number;
+              highWaterMark: number;
+              averageDepth: number;
+              overflowsAvoided: number;
+          }
+        | undefined = undefined;
+
     isRTL: boolean = false;
 
     get isPaused() {
@@ -182,6 +192,7 @@ export abstract class RuntimeBase {
             showNextQueueTask: action,
             freeMemory: observable,
             totalMemory: observable,
+            queueStats: observable,
             isRTL: observable
         });
 
@@ -199,6 +210,7 @@ export abstract class RuntimeBase {
 
         runInAction(() => {
             this.isDebuggerActive = isDebuggerActive;
+            this.queueStats = undefined;
         });
 
         this.doStartRuntime(isDebuggerActive);
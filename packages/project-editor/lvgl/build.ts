@@ -1377,6 +1377,13 @@ export async function generateSourceCodeForEezFramework(
         );
     }
 
+    if (project.settings.build.parallelFlowDefinitionDecompression) {
+        eezH = eezH.replace(
+            "#define EEZ_ASSETS_PARALLEL_DECOMPRESSION 0",
+            "#define EEZ_ASSETS_PARALLEL_DECOMPRESSION 1"
+        );
+    }
+
     eezH = eezH.replace(
         "#define EEZ_FLOW_QUEUE_SIZE 1000",
         "#define EEZ_FLOW_QUEUE_SIZE " +
@@ -272,6 +272,7 @@ export class Build extends EezObject {
     lvglInclude: string;
     generateSourceCodeForEezFramework: boolean;
     compressFlowDefinition: boolean;
+    parallelFlowDefinitionDecompression: boolean;
     executionQueueSize: number;
     expressionEvaluatorStackSize: number;
 
@@ -323,6 +324,18 @@ export class Build extends EezObject {
                     !getProject(object).projectTypeTraits.hasFlowSupport ||
                     !object.generateSourceCodeForEezFramework
             },
+            {
+                name: "parallelFlowDefinitionDecompression",
+                displayName:
+                    "Parallel flow definition decompression (hosted targets only)",
+                type: PropertyType.Boolean,
+                checkboxStyleSwitch: true,
+                disabled: (object: Build) =>
+                    isNotLVGLProject(object) ||
+                    !getProject(object).projectTypeTraits.hasFlowSupport ||
+                    !object.generateSourceCodeForEezFramework ||
+                    !object.compressFlowDefinition
+            },
             {
                 name: "executionQueueSize",
                 type: PropertyType.Number,
@@ -354,6 +367,10 @@ export class Build extends EezObject {
                 jsObject.compressFlowDefinition = false;
             }
 
+            if (jsObject.parallelFlowDefinitionDecompression == undefined) {
+                jsObject.parallelFlowDefinitionDecompression = false;
+            }
+
             if (jsObject.executionQueueSize == undefined) {
                 jsObject.executionQueueSize = 1000;
             }
@@ -389,6 +406,7 @@ export class Build extends EezObject {
             lvglInclude: observable,
             generateSourceCodeForEezFramework: observable,
             compressFlowDefinition: observable,
+            parallelFlowDefinitionDecompression: observable,
             executionQueueSize: observable,
             expressionEvaluatorStackSize: observable
         });
@@ -14,9 +14,19 @@
 
 /*************************** HEADER FILES ***************************/
 #include <stdlib.h>
+#include <stdint.h>
 #include <memory.h>
 #include "eez-flow-sha256.h"
 
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define SHA256_USE_SHA_NI
+#include <cpuid.h>
+#include <immintrin.h>
+#elif (defined(__ARM_FEATURE_SHA2) || defined(__ARM_FEATURE_CRYPTO)) && defined(__ARM_NEON)
+#define SHA256_USE_ARMV8_CRYPTO
+#include <arm_neon.h>
+#endif
+
 /****************************** MACROS ******************************/
 #define ROTLEFT(a,b) (((a) << (b)) | ((a) >> (32-(b))))
 #define ROTRIGHT(a,b) (((a) >> (b)) | ((a) << (32-(b))))
@@ -41,7 +51,7 @@ static const WORD k[64] = {
 };
 
 /*********************** FUNCTION DEFINITIONS ***********************/
-void sha256_transform(SHA256_CTX *ctx, const BYTE data[])
+static void sha256_transform(SHA256_CTX *ctx, const BYTE data[])
 {
 	WORD a, b, c, d, e, f, g, h, i, j, t1, t2, m[64];
 
@@ -82,6 +92,134 @@ void sha256_transform(SHA256_CTX *ctx, const BYTE data[])
 	ctx->state[7] += h;
 }
 
+static void sha256_transform_blocks_generic(SHA256_CTX *ctx, const BYTE data[], size_t numBlocks)
+{
+	for (; numBlocks > 0; --numBlocks, data += 64)
+		sha256_transform(ctx, data);
+}
+
+#if defined(SHA256_USE_SHA_NI)
+// Uses the x86 SHA extensions, 4 rounds per pair of sha256rnds2 instructions.
+__attribute__((target("sha,sse4.1,ssse3")))
+static void sha256_transform_blocks_sha_ni(SHA256_CTX *ctx, const BYTE data[], size_t numBlocks)
+{
+	const __m128i MASK = _mm_set_epi64x(0x0c0d0e0f08090a0bULL, 0x0405060700010203ULL);
+	__m128i STATE0, STATE1, MSG, TMP, ABEF_SAVE, CDGH_SAVE;
+	__m128i W[4];
+	int g;
+
+	TMP = _mm_loadu_si128((const __m128i *)&ctx->state[0]);
+	STATE1 = _mm_loadu_si128((const __m128i *)&ctx->state[4]);
+	TMP = _mm_shuffle_epi32(TMP, 0xB1);          // CDAB
+	STATE1 = _mm_shuffle_epi32(STATE1, 0x1B);    // EFGH
+	STATE0 = _mm_alignr_epi8(TMP, STATE1, 8);    // ABEF
+	STATE1 = _mm_blend_epi16(STATE1, TMP, 0xF0); // CDGH
+
+	for (; numBlocks > 0; --numBlocks, data += 64) {
+		ABEF_SAVE = STATE0;
+		CDGH_SAVE = STATE1;
+
+		for (g = 0; g < 16; ++g) {
+			if (g < 4) {
+				W[g] = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i *)(data + 16 * g)), MASK);
+			} else {
+				W[g % 4] = _mm_sha256msg2_epu32(
+					_mm_add_epi32(_mm_sha256msg1_epu32(W[g % 4], W[(g + 1) % 4]), _mm_alignr_epi8(W[(g + 3) % 4], W[(g + 2) % 4], 4)),
+					W[(g + 3) % 4]);
+			}
+			MSG = _mm_add_epi32(W[g % 4], _mm_loadu_si128((const __m128i *)&k[4 * g]));
+			STATE1 = _mm_sha256rnds2_epu32(STATE1, STATE0, MSG);
+			MSG = _mm_shuffle_epi32(MSG, 0x0E);
+			STATE0 = _mm_sha256rnds2_epu32(STATE0, STATE1, MSG);
+		}
+
+		STATE0 = _mm_add_epi32(STATE0, ABEF_SAVE);
+		STATE1 = _mm_add_epi32(STATE1, CDGH_SAVE);
+	}
+
+	TMP = _mm_shuffle_epi32(STATE0, 0x1B);       // FEBA
+	STATE1 = _mm_shuffle_epi32(STATE1, 0xB1);    // DCHG
+	STATE0 = _mm_blend_epi16(TMP, STATE1, 0xF0); // DCBA
+	STATE1 = _mm_alignr_epi8(STATE1, TMP, 8);    // HGFE
+	_mm_storeu_si128((__m128i *)&ctx->state[0], STATE0);
+	_mm_storeu_si128((__m128i *)&ctx->state[4], STATE1);
+}
+
+static int sha256_has_sha_ni(void)
+{
+	unsigned int eax, ebx, ecx, edx;
+	if (!__get_cpuid(1, &eax, &ebx, &ecx, &edx) || !(ecx & bit_SSE4_1) || !(ecx & bit_SSSE3))
+		return 0;
+	if (__get_cpuid_max(0, 0) < 7)
+		return 0;
+	__cpuid_count(7, 0, eax, ebx, ecx, edx);
+	return (ebx & (1 << 29)) != 0;
+}
+#endif
+
+#if defined(SHA256_USE_ARMV8_CRYPTO)
+// Uses the ARMv8 cryptography extensions, 4 rounds per sha256h/sha256h2 pair.
+static void sha256_transform_blocks_armv8(SHA256_CTX *ctx, const BYTE data[], size_t numBlocks)
+{
+	uint32x4_t STATE0, STATE1, ABEF_SAVE, CDGH_SAVE, TMP0, TMP2;
+	uint32x4_t W[4];
+	int g;
+
+	STATE0 = vld1q_u32(&ctx->state[0]);
+	STATE1 = vld1q_u32(&ctx->state[4]);
+
+	for (; numBlocks > 0; --numBlocks, data += 64) {
+		ABEF_SAVE = STATE0;
+		CDGH_SAVE = STATE1;
+
+		for (g = 0; g < 4; ++g)
+			W[g] = vreinterpretq_u32_u8(vrev32q_u8(vld1q_u8(data + 16 * g)));
+
+		for (g = 0; g < 16; ++g) {
+			TMP0 = vaddq_u32(W[g % 4], vld1q_u32(&k[4 * g]));
+			if (g < 12)
+				W[g % 4] = vsha256su1q_u32(vsha256su0q_u32(W[g % 4], W[(g + 1) % 4]), W[(g + 2) % 4], W[(g + 3) % 4]);
+			TMP2 = STATE0;
+			STATE0 = vsha256hq_u32(STATE0, STATE1, TMP0);
+			STATE1 = vsha256h2q_u32(STATE1, TMP2, TMP0);
+		}
+
+		STATE0 = vaddq_u32(STATE0, ABEF_SAVE);
+		STATE1 = vaddq_u32(STATE1, CDGH_SAVE);
+	}
+
+	vst1q_u32(&ctx->state[0], STATE0);
+	vst1q_u32(&ctx->state[4], STATE1);
+}
+#endif
+
+typedef void (*sha256_transform_blocks_fn)(SHA256_CTX *ctx, const BYTE data[], size_t numBlocks);
+
+static void sha256_transform_blocks_select(SHA256_CTX *ctx, const BYTE data[], size_t numBlocks);
+
+static sha256_transform_blocks_fn sha256_transform_blocks = sha256_transform_blocks_select;
+
+// Picks the fastest implementation on first use.
+static void sha256_transform_blocks_select(SHA256_CTX *ctx, const BYTE data[], size_t numBlocks)
+{
+#if defined(SHA256_USE_SHA_NI)
+	sha256_transform_blocks = sha256_has_sha_ni() ? sha256_transform_blocks_sha_ni : sha256_transform_blocks_generic;
+#elif defined(SHA256_USE_ARMV8_CRYPTO)
+	sha256_transform_blocks = sha256_transform_blocks_armv8;
+#else
+	sha256_transform_blocks = sha256_transform_blocks_generic;
+#endif
+	sha256_transform_blocks(ctx, data, numBlocks);
+}
+
+void sha256_transform_blocks_portable(int portable)
+{
+	if (portable)
+		sha256_transform_blocks = sha256_transform_blocks_generic;
+	else
+		sha256_transform_blocks = sha256_transform_blocks_select;
+}
+
 void sha256_init(SHA256_CTX *ctx)
 {
 	ctx->datalen = 0;
@@ -98,17 +236,34 @@ void sha256_init(SHA256_CTX *ctx)
 
 void sha256_update(SHA256_CTX *ctx, const BYTE data[], size_t len)
 {
-	WORD i;
+	size_t n;
 
-	for (i = 0; i < len; ++i) {
-		ctx->data[ctx->datalen] = data[i];
-		ctx->datalen++;
-		if (ctx->datalen == 64) {
-			sha256_transform(ctx, ctx->data);
-			ctx->bitlen += 512;
-			ctx->datalen = 0;
-		}
+	if (ctx->datalen > 0) {
+		n = 64 - ctx->datalen;
+		if (n > len)
+			n = len;
+		memcpy(ctx->data + ctx->datalen, data, n);
+		ctx->datalen += n;
+		data += n;
+		len -= n;
+		if (ctx->datalen < 64)
+			return;
+		sha256_transform_blocks(ctx, ctx->data, 1);
+		ctx->bitlen += 512;
+		ctx->datalen = 0;
 	}
+
+	// Full blocks are hashed straight from the input buffer.
+	n = len / 64;
+	if (n > 0) {
+		sha256_transform_blocks(ctx, data, n);
+		ctx->bitlen += 512ULL * n;
+		data += 64 * n;
+		len -= 64 * n;
+	}
+
+	memcpy(ctx->data, data, len);
+	ctx->datalen = len;
 }
 
 void sha256_final(SHA256_CTX *ctx, BYTE hash[])
@@ -127,7 +282,7 @@ void sha256_final(SHA256_CTX *ctx, BYTE hash[])
 		ctx->data[i++] = 0x80;
 		while (i < 64)
 			ctx->data[i++] = 0x00;
-		sha256_transform(ctx, ctx->data);
+		sha256_transform_blocks(ctx, ctx->data, 1);
 		memset(ctx->data, 0, 56);
 	}
 
@@ -141,7 +296,7 @@ void sha256_final(SHA256_CTX *ctx, BYTE hash[])
 	ctx->data[58] = ctx->bitlen >> 40;
 	ctx->data[57] = ctx->bitlen >> 48;
 	ctx->data[56] = ctx->bitlen >> 56;
-	sha256_transform(ctx, ctx->data);
+	sha256_transform_blocks(ctx, ctx->data, 1);
 
 	// Since this implementation uses little endian byte ordering and SHA uses big endian,
 	// reverse all the bytes when copying the final state to the output hash.
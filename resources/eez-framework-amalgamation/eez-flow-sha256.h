@@ -30,5 +30,8 @@ typedef struct {
 void sha256_init(SHA256_CTX *ctx);
 void sha256_update(SHA256_CTX *ctx, const BYTE data[], size_t len);
 void sha256_final(SHA256_CTX *ctx, BYTE hash[]);
+// Forces the portable implementation (for testing and benchmarking), or
+// re-enables the hardware accelerated one when portable is 0.
+void sha256_transform_blocks_portable(int portable);
 
 #endif   // SHA256_H
@@ -1,4 +1,4 @@
-/* Autogenerated on September 17, 2024 4:49:42 PM from eez-framework commit 03a09f68d00aaa6366fb2b5132e6180a4c8711ca */
+/* Autogenerated on September 17, 2024 4:49:42 PM from eez-framework commit 03a09f68d00aaa6366fb2b5132e6180a4c8711ca, modified by hand since then (see tools/eez-framework-amalgamation/README.md) */
 /*
  * eez-framework
  *
@@ -27,13 +27,20 @@ namespace eez {
 #if EEZ_OPTION_GUI
 namespace gui {
 #endif
-void executeActionFunction(int actionId) {
+static void doExecuteActionFunction(int actionId) {
 #if defined(EEZ_FOR_LVGL)
 	eez::flow::executeLvglActionHook(actionId - 1);
 #else
     g_actionExecFunctions[actionId]();
 #endif
 }
+void executeActionFunction(int actionId) {
+    if (flow::g_runtime->traceMode != flow::TRACE_MODE_OFF) {
+        flow::traceActionFunction(actionId, doExecuteActionFunction);
+        return;
+    }
+    doExecuteActionFunction(actionId);
+}
 #if EEZ_OPTION_GUI
 } 
 #endif
@@ -57,14 +64,18 @@ namespace eez {
 void initAllocHeap(uint8_t *heap, size_t heapSize) {
 }
 void *alloc(size_t size, uint32_t id) {
-#if LVGL_VERSION_MAJOR >= 9
+#if EEZ_FLOW_THREAD_SAFE_ALLOC
+    return ::malloc(size);
+#elif LVGL_VERSION_MAJOR >= 9
     return lv_malloc(size);
 #else
     return lv_mem_alloc(size);
 #endif
 }
 void free(void *ptr) {
-#if LVGL_VERSION_MAJOR >= 9
+#if EEZ_FLOW_THREAD_SAFE_ALLOC
+    ::free(ptr);
+#elif LVGL_VERSION_MAJOR >= 9
     lv_free(ptr);
 #else
     lv_mem_free(ptr);
@@ -72,11 +83,7 @@ void free(void *ptr) {
 }
 template<typename T> void freeObject(T *ptr) {
 	ptr->~T();
-#if LVGL_VERSION_MAJOR >= 9
-    lv_free(ptr);
-#else
-	lv_mem_free(ptr);
-#endif
+	free(ptr);
 }
 void getAllocInfo(uint32_t &free, uint32_t &alloc) {
     lv_mem_monitor_t mon;
@@ -246,6 +253,13 @@ void getAllocInfo(uint32_t &free, uint32_t &alloc) {
 #include <string.h>
 #if EEZ_FOR_LVGL_LZ4_OPTION
 #endif
+#if EEZ_FLOW_PARALLEL_ACTIONS
+#include <mutex>
+#endif
+#if EEZ_ASSETS_PARALLEL_DECOMPRESSION
+#include <atomic>
+#include <thread>
+#endif
 #if EEZ_OPTION_GUI
 using namespace eez::gui;
 #endif
@@ -256,15 +270,17 @@ using namespace eez::gui;
 #define SCPI_ERROR_INVALID_BLOCK_DATA -161
 #endif
 namespace eez {
-bool g_isMainAssetsLoaded;
-Assets *g_mainAssets;
-bool g_mainAssetsUncompressed;
-Assets *g_externalAssets;
 void fixOffsets(Assets *assets);
 bool decompressAssetsData(const uint8_t *assetsData, uint32_t assetsDataSize, Assets *decompressedAssets, uint32_t maxDecompressedAssetsSize, int *err) {
 	uint32_t compressedDataOffset;
 	uint32_t decompressedSize;
 	auto header = (Header *)assetsData;
+	if (header->tag == HEADER_TAG_SECTIONED) {
+		if (err) {
+			*err = SCPI_ERROR_INVALID_BLOCK_DATA;
+		}
+		return false;
+	}
 	if (header->tag == HEADER_TAG_COMPRESSED) {
 		decompressedAssets->projectMajorVersion = header->projectMajorVersion;
 		decompressedAssets->projectMinorVersion = header->projectMinorVersion;
@@ -322,113 +338,516 @@ void allocMemoryForDecompressedAssets(const uint8_t *assetsData, uint32_t assets
 #pragma GCC diagnostic pop
 #endif
     auto header = (Header *)assetsData;
-    assert (header->tag == HEADER_TAG_COMPRESSED);
+    assert (header->tag == HEADER_TAG_COMPRESSED || header->tag == HEADER_TAG_SECTIONED);
     uint32_t decompressedSize = header->decompressedSize;
     decompressedAssetsMemoryBufferSize = decompressedDataOffset + decompressedSize;
     decompressedAssetsMemoryBuffer = (uint8_t *)eez::alloc(decompressedAssetsMemoryBufferSize, 0x587da194);
 }
+struct AssetsSections {
+    const uint8_t *assetsData;
+    uint32_t numSections;
+    const AssetsSection *sections;
+    uint32_t firstSection[ASSETS_SECTION_NUM_TYPES];
+    uint32_t numSectionsOfType[ASSETS_SECTION_NUM_TYPES];
+    uint8_t **data;
+    AssetsSectionStats stats;
+#if EEZ_FLOW_PARALLEL_ACTIONS
+    std::mutex mutex;
+#endif
+};
+void freeAssetsSections(AssetsSections *sections) {
+    if (!sections) {
+        return;
+    }
+    if (sections->data) {
+        for (uint32_t i = 0; i < sections->numSections; i++) {
+            if (sections->data[i]) {
+                free(sections->data[i]);
+            }
+        }
+        free(sections->data);
+    }
+    ObjectAllocator<AssetsSections>::deallocate(sections);
+}
+static AssetsSections *createAssetsSections(const uint8_t *assetsData, uint32_t assetsDataSize) {
+    auto header = (const Header *)assetsData;
+    uint32_t tableOffset = sizeof(Header) + sizeof(uint32_t);
+    if (assetsDataSize < tableOffset) {
+        return nullptr;
+    }
+    auto numSections = *(const uint32_t *)(assetsData + sizeof(Header));
+    if (numSections == 0 || numSections > (assetsDataSize - tableOffset) / sizeof(AssetsSection)) {
+        return nullptr;
+    }
+    auto sections = ObjectAllocator<AssetsSections>::allocate(0x6d2b83c4);
+    if (!sections) {
+        return nullptr;
+    }
+    sections->assetsData = assetsData;
+    sections->numSections = numSections;
+    sections->sections = (const AssetsSection *)(assetsData + tableOffset);
+    for (uint8_t type = 0; type < ASSETS_SECTION_NUM_TYPES; type++) {
+        sections->firstSection[type] = 0;
+        sections->numSectionsOfType[type] = 0;
+    }
+    sections->data = (uint8_t **)alloc(numSections * sizeof(uint8_t *), 0x0f61c2b5);
+    sections->stats = {};
+    sections->stats.numSections = numSections;
+    if (!sections->data) {
+        freeAssetsSections(sections);
+        return nullptr;
+    }
+    for (uint32_t i = 0; i < numSections; i++) {
+        sections->data[i] = nullptr;
+    }
+    for (uint32_t i = 0; i < numSections; i++) {
+        auto &section = sections->sections[i];
+        if (
+            section.type >= ASSETS_SECTION_NUM_TYPES ||
+            section.compressedOffset < tableOffset + numSections * sizeof(AssetsSection) ||
+            section.compressedOffset > assetsDataSize ||
+            section.compressedSize > assetsDataSize - section.compressedOffset
+        ) {
+            freeAssetsSections(sections);
+            return nullptr;
+        }
+        auto &numSectionsOfType = sections->numSectionsOfType[section.type];
+        if (numSectionsOfType == 0) {
+            sections->firstSection[section.type] = i;
+        } else if (sections->firstSection[section.type] + numSectionsOfType != i) {
+            freeAssetsSections(sections);
+            return nullptr;
+        }
+        if (section.index != numSectionsOfType) {
+            freeAssetsSections(sections);
+            return nullptr;
+        }
+        numSectionsOfType++;
+    }
+    uint64_t coreSize = 0;
+    for (uint32_t i = 0; i < sections->numSectionsOfType[ASSETS_SECTION_CORE]; i++) {
+        coreSize += sections->sections[i].decompressedSize;
+    }
+    if (
+        sections->numSectionsOfType[ASSETS_SECTION_CORE] == 0 ||
+        sections->firstSection[ASSETS_SECTION_CORE] != 0 ||
+        coreSize != header->decompressedSize
+    ) {
+        freeAssetsSections(sections);
+        return nullptr;
+    }
+    sections->stats.numCoreBlocks = sections->numSectionsOfType[ASSETS_SECTION_CORE];
+    return sections;
+}
+static bool decompressAssetsSection(AssetsSections *sections, uint32_t sectionIndex, uint8_t *decompressedData) {
+#if EEZ_FOR_LVGL_LZ4_OPTION
+    auto &section = sections->sections[sectionIndex];
+    int decompressResult = LZ4_decompress_safe(
+        (const char *)(sections->assetsData + section.compressedOffset),
+        (char *)decompressedData,
+        section.compressedSize,
+        section.decompressedSize
+    );
+    return decompressResult == (int)section.decompressedSize;
+#else
+    return false;
+#endif
+}
+void setAssetsDecompressionThreads(unsigned numThreads) {
+    flow::g_runtime->assetsDecompressionThreads = numThreads;
+}
+unsigned getAssetsDecompressionThreads() {
+    return flow::g_runtime->assetsDecompressionThreads;
+}
+struct AssetsCoreBlocks {
+    AssetsSections *sections;
+    uint8_t *decompressedData;
+    uint32_t *offsets;
+    uint32_t numBlocks;
+#if EEZ_ASSETS_PARALLEL_DECOMPRESSION
+    std::atomic<uint32_t> nextBlock;
+    std::atomic<bool> failed;
+#else
+    uint32_t nextBlock;
+    bool failed;
+#endif
+};
+static void decompressAssetsCoreBlocks(AssetsCoreBlocks *blocks) {
+    while (!blocks->failed) {
+        uint32_t blockIndex = blocks->nextBlock++;
+        if (blockIndex >= blocks->numBlocks) {
+            break;
+        }
+        if (!decompressAssetsSection(blocks->sections, blockIndex, blocks->decompressedData + blocks->offsets[blockIndex])) {
+            blocks->failed = true;
+        }
+    }
+}
+static bool decompressAssetsCore(AssetsSections *sections, uint8_t *decompressedData) {
+    AssetsCoreBlocks blocks;
+    blocks.sections = sections;
+    blocks.decompressedData = decompressedData;
+    blocks.numBlocks = sections->numSectionsOfType[ASSETS_SECTION_CORE];
+    blocks.offsets = (uint32_t *)alloc(blocks.numBlocks * sizeof(uint32_t), 0x41c9e06b);
+    if (!blocks.offsets) {
+        return false;
+    }
+    uint32_t offset = 0;
+    for (uint32_t i = 0; i < blocks.numBlocks; i++) {
+        blocks.offsets[i] = offset;
+        offset += sections->sections[i].decompressedSize;
+    }
+    blocks.nextBlock = 0;
+    blocks.failed = false;
+    unsigned numThreads = 1;
+#if EEZ_ASSETS_PARALLEL_DECOMPRESSION
+    numThreads = flow::g_runtime->assetsDecompressionThreads;
+    if (numThreads == 0) {
+        numThreads = std::thread::hardware_concurrency();
+    }
+    if (numThreads > blocks.numBlocks) {
+        numThreads = blocks.numBlocks;
+    }
+    std::thread *threads = nullptr;
+    if (numThreads > 1) {
+        threads = (std::thread *)alloc((numThreads - 1) * sizeof(std::thread), 0xb8e2f157);
+    }
+    if (!threads) {
+        numThreads = 1;
+    }
+    for (unsigned i = 0; i < numThreads - 1; i++) {
+        new (threads + i) std::thread(decompressAssetsCoreBlocks, &blocks);
+    }
+#endif
+    decompressAssetsCoreBlocks(&blocks);
+#if EEZ_ASSETS_PARALLEL_DECOMPRESSION
+    for (unsigned i = 0; i < numThreads - 1; i++) {
+        threads[i].join();
+        threads[i].~thread();
+    }
+    if (threads) {
+        eez::free(threads);
+    }
+#endif
+    free(blocks.offsets);
+    if (blocks.failed) {
+        return false;
+    }
+    sections->stats.numDecompressions += blocks.numBlocks;
+    sections->stats.numDecompressionThreads = numThreads;
+    return true;
+}
+static bool loadAssetsSections(const uint8_t *assetsData, uint32_t assetsDataSize, Assets *decompressedAssets, uint32_t maxDecompressedAssetsSize) {
+    auto sections = createAssetsSections(assetsData, assetsDataSize);
+    if (!sections) {
+        return false;
+    }
+#ifdef __GNUC__
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Winvalid-offsetof"
+#endif
+	auto decompressedDataOffset = offsetof(Assets, settings);
+#ifdef __GNUC__
+#pragma GCC diagnostic pop
+#endif
+    auto header = (const Header *)assetsData;
+    if (
+        decompressedDataOffset + header->decompressedSize > maxDecompressedAssetsSize ||
+        !decompressAssetsCore(sections, (uint8_t *)decompressedAssets + decompressedDataOffset)
+    ) {
+        freeAssetsSections(sections);
+        return false;
+    }
+    decompressedAssets->projectMajorVersion = header->projectMajorVersion;
+    decompressedAssets->projectMinorVersion = header->projectMinorVersion;
+    decompressedAssets->assetsType = header->assetsType;
+    sections->stats.numResidentSections = sections->stats.numCoreBlocks;
+    sections->stats.residentSize = header->decompressedSize;
+    flow::g_runtime->mainAssetsSections = sections;
+    return true;
+}
+void *getAssetsSection(Assets *assets, uint8_t type, uint32_t index) {
+    auto sections = flow::g_runtime->mainAssetsSections;
+    if (!sections || assets != flow::g_runtime->mainAssets || type == ASSETS_SECTION_CORE || type >= ASSETS_SECTION_NUM_TYPES || index >= sections->numSectionsOfType[type]) {
+        return nullptr;
+    }
+#if EEZ_FLOW_PARALLEL_ACTIONS
+    std::lock_guard<std::mutex> lock(sections->mutex);
+#endif
+    auto sectionIndex = sections->firstSection[type] + index;
+    if (sections->data[sectionIndex]) {
+        return sections->data[sectionIndex];
+    }
+    auto size = sections->sections[sectionIndex].decompressedSize;
+    auto data = (uint8_t *)alloc(size, 0x2c87e4f9);
+    if (!data) {
+        return nullptr;
+    }
+    if (!decompressAssetsSection(sections, sectionIndex, data)) {
+        free(data);
+        return nullptr;
+    }
+    sections->stats.numDecompressions++;
+    sections->data[sectionIndex] = data;
+    sections->stats.numResidentSections++;
+    sections->stats.residentSize += size;
+    return data;
+}
+const ListOfAssetsPtr<const char> *getLanguageTranslations(Assets *assets, uint32_t languageIndex) {
+    if (languageIndex >= assets->languages.count) {
+        return nullptr;
+    }
+    auto translations = (const ListOfAssetsPtr<const char> *)getAssetsSection(assets, ASSETS_SECTION_LANGUAGE, languageIndex);
+    if (translations) {
+        return translations;
+    }
+    return &assets->languages[languageIndex]->translations;
+}
+AssetsSectionStats getAssetsSectionStats() {
+    auto sections = flow::g_runtime->mainAssetsSections;
+    if (!sections) {
+        return {};
+    }
+#if EEZ_FLOW_PARALLEL_ACTIONS
+    std::lock_guard<std::mutex> lock(sections->mutex);
+#endif
+    return sections->stats;
+}
+static uint32_t hashAssetsName(const char *name) {
+    uint32_t hash = 2166136261u;
+    while (*name) {
+        hash = (hash ^ (uint8_t)*name++) * 16777619u;
+    }
+    return hash;
+}
+void freeAssetsNameTable(AssetsNameTable &table) {
+    if (table.slots) {
+        free(table.slots);
+    }
+    table.items = nullptr;
+    table.count = 0;
+    table.getName = nullptr;
+    table.mask = 0;
+    table.slots = nullptr;
+}
+static const uint32_t ASSETS_NAME_TABLE_MIN_INDEXED_COUNT = 16;
+bool buildAssetsNameTable(AssetsNameTable &table, const void *items, uint32_t count, AssetsNameGetter getName) {
+    freeAssetsNameTable(table);
+    table.items = items;
+    table.count = count;
+    table.getName = getName;
+    if (count < ASSETS_NAME_TABLE_MIN_INDEXED_COUNT) {
+        return true;
+    }
+    uint32_t numSlots = ASSETS_NAME_TABLE_MIN_INDEXED_COUNT;
+    while (numSlots < 2 * count) {
+        numSlots <<= 1;
+    }
+    table.slots = (AssetsNameSlot *)alloc(numSlots * sizeof(AssetsNameSlot), 0x5be0c2d7);
+    if (!table.slots) {
+        return false;
+    }
+    table.mask = numSlots - 1;
+    for (uint32_t i = 0; i < numSlots; i++) {
+        table.slots[i].index = 0;
+    }
+    for (uint32_t i = 0; i < count; i++) {
+        auto name = getName(items, i);
+        if (!name) {
+            continue;
+        }
+        auto hash = hashAssetsName(name);
+        auto slotIndex = hash & table.mask;
+        for (; table.slots[slotIndex].index; slotIndex = (slotIndex + 1) & table.mask) {
+            auto &slot = table.slots[slotIndex];
+            if (slot.hash == hash && strcmp(getName(items, slot.index - 1), name) == 0) {
+                break;
+            }
+        }
+        if (!table.slots[slotIndex].index) {
+            table.slots[slotIndex].hash = hash;
+            table.slots[slotIndex].index = i + 1;
+        }
+    }
+    return true;
+}
+int32_t findAssetsNameTable(const AssetsNameTable &table, const char *name) {
+    if (!table.slots) {
+        for (uint32_t i = 0; i < table.count; i++) {
+            auto itemName = table.getName(table.items, i);
+            if (itemName && strcmp(itemName, name) == 0) {
+                return i;
+            }
+        }
+        return -1;
+    }
+    auto hash = hashAssetsName(name);
+    for (auto slotIndex = hash & table.mask; table.slots[slotIndex].index; slotIndex = (slotIndex + 1) & table.mask) {
+        auto &slot = table.slots[slotIndex];
+        if (slot.hash == hash && strcmp(table.getName(table.items, slot.index - 1), name) == 0) {
+            return slot.index - 1;
+        }
+    }
+    return -1;
+}
+#if EEZ_OPTION_GUI
+static const char *getBitmapName(const void *items, uint32_t index) {
+    auto bitmap = (*(ListOfAssetsPtr<gui::Bitmap> *)items)[index];
+    return bitmap ? (const char *)bitmap->name : nullptr;
+}
+#endif
+static const char *getListItemName(const void *items, uint32_t index) {
+    return (*(ListOfAssetsPtr<const char> *)items)[index];
+}
+static const char *getLanguageName(const void *items, uint32_t index) {
+    auto language = (*(ListOfAssetsPtr<Language> *)items)[index];
+    return language ? (const char *)language->languageID : nullptr;
+}
+static void freeAssetsNameIndex(AssetsNameIndex &index) {
+    for (uint8_t nameTable = 0; nameTable < ASSETS_NAME_TABLE_NUM; nameTable++) {
+        freeAssetsNameTable(index.tables[nameTable]);
+    }
+    index.assets = nullptr;
+}
+static void buildAssetsNameIndex(AssetsNameIndex &index, Assets *assets) {
+    freeAssetsNameIndex(index);
+    index.assets = assets;
+#if EEZ_OPTION_GUI
+    buildAssetsNameTable(index.tables[ASSETS_NAME_TABLE_BITMAPS], &assets->bitmaps, assets->bitmaps.count, getBitmapName);
+#endif
+    buildAssetsNameTable(index.tables[ASSETS_NAME_TABLE_ACTIONS], &assets->actionNames, assets->actionNames.count, getListItemName);
+    buildAssetsNameTable(index.tables[ASSETS_NAME_TABLE_VARIABLES], &assets->variableNames, assets->variableNames.count, getListItemName);
+    buildAssetsNameTable(index.tables[ASSETS_NAME_TABLE_LANGUAGES], &assets->languages, assets->languages.count, getLanguageName);
+}
+void buildAssetsNameIndex(Assets *assets) {
+    buildAssetsNameIndex(assets == flow::g_runtime->mainAssets ? flow::g_runtime->mainAssetsNameIndex : flow::g_runtime->externalAssetsNameIndex, assets);
+}
+void freeAssetsNameIndex(Assets *assets) {
+    if (flow::g_runtime->mainAssetsNameIndex.assets == assets) {
+        freeAssetsNameIndex(flow::g_runtime->mainAssetsNameIndex);
+    }
+    if (flow::g_runtime->externalAssetsNameIndex.assets == assets) {
+        freeAssetsNameIndex(flow::g_runtime->externalAssetsNameIndex);
+    }
+}
+int32_t findAssetsName(Assets *assets, uint8_t nameTable, const char *name) {
+    if (!assets || nameTable >= ASSETS_NAME_TABLE_NUM) {
+        return -1;
+    }
+    auto &index = assets == flow::g_runtime->mainAssets ? flow::g_runtime->mainAssetsNameIndex : flow::g_runtime->externalAssetsNameIndex;
+    if (index.assets != assets) {
+        buildAssetsNameIndex(index, assets);
+    }
+    return findAssetsNameTable(index.tables[nameTable], name);
+}
 void loadMainAssets(const uint8_t *assets, uint32_t assetsSize) {
+    freeAssetsSections(flow::g_runtime->mainAssetsSections);
+    flow::g_runtime->mainAssetsSections = nullptr;
     auto header = (Header *)assets;
     if (header->tag == HEADER_TAG) {
-        g_mainAssets = (Assets *)(assets + sizeof(uint32_t));
-        g_mainAssetsUncompressed = true;
+        flow::g_runtime->mainAssets = (Assets *)(assets + sizeof(uint32_t));
+        flow::g_runtime->mainAssetsUncompressed = true;
     } else {
 #if defined(EEZ_FOR_LVGL) || defined(EEZ_DASHBOARD_API)
         uint8_t *DECOMPRESSED_ASSETS_START_ADDRESS = 0;
         uint32_t MAX_DECOMPRESSED_ASSETS_SIZE = 0;
         allocMemoryForDecompressedAssets(assets, assetsSize, DECOMPRESSED_ASSETS_START_ADDRESS, MAX_DECOMPRESSED_ASSETS_SIZE);
 #endif
-        g_mainAssets = (Assets *)DECOMPRESSED_ASSETS_START_ADDRESS;
-        g_mainAssetsUncompressed = false;
-        g_mainAssets->external = false;
-        auto decompressedSize = decompressAssetsData(assets, assetsSize, g_mainAssets, MAX_DECOMPRESSED_ASSETS_SIZE, nullptr);
-        assert(decompressedSize);
+        flow::g_runtime->mainAssets = (Assets *)DECOMPRESSED_ASSETS_START_ADDRESS;
+        flow::g_runtime->mainAssetsUncompressed = false;
+        flow::g_runtime->mainAssets->external = false;
+        if (header->tag == HEADER_TAG_SECTIONED) {
+            auto loaded = loadAssetsSections(assets, assetsSize, flow::g_runtime->mainAssets, MAX_DECOMPRESSED_ASSETS_SIZE);
+            assert(loaded);
+        } else {
+            auto decompressedSize = decompressAssetsData(assets, assetsSize, flow::g_runtime->mainAssets, MAX_DECOMPRESSED_ASSETS_SIZE, nullptr);
+            assert(decompressedSize);
+        }
     }
-    g_isMainAssetsLoaded = true;
+    flow::g_runtime->isMainAssetsLoaded = true;
+    flow::buildFlowMetadataIndex(flow::g_runtime->mainAssets);
+    buildAssetsNameIndex(flow::g_runtime->mainAssets);
 }
 void unloadExternalAssets() {
-	if (g_externalAssets) {
+	if (flow::g_runtime->externalAssets) {
 #if EEZ_OPTION_GUI
 		removeExternalPagesFromTheStack();
 #endif
-		free(g_externalAssets);
-		g_externalAssets = nullptr;
+		flow::freeFlowMetadataIndex(flow::g_runtime->externalAssets);
+		freeAssetsNameIndex(flow::g_runtime->externalAssets);
+		free(flow::g_runtime->externalAssets);
+		flow::g_runtime->externalAssets = nullptr;
 	}
 }
 #if EEZ_OPTION_GUI
 const gui::PageAsset* getPageAsset(int pageId) {
 	if (pageId > 0) {
-		return g_mainAssets->pages[pageId - 1];
+		return flow::g_runtime->mainAssets->pages[pageId - 1];
 	} else if (pageId < 0) {
-		if (g_externalAssets == nullptr) {
+		if (flow::g_runtime->externalAssets == nullptr) {
 			return nullptr;
 		}
-		return g_externalAssets->pages[-pageId - 1];
+		return flow::g_runtime->externalAssets->pages[-pageId - 1];
 	}
 	return nullptr;
 }
 const gui::PageAsset *getPageAsset(int pageId, WidgetCursor& widgetCursor) {
 	if (pageId < 0) {
-		widgetCursor.assets = g_externalAssets;
-		widgetCursor.flowState = flow::getPageFlowState(g_externalAssets, -pageId - 1, widgetCursor);
+		widgetCursor.assets = flow::g_runtime->externalAssets;
+		widgetCursor.flowState = flow::getPageFlowState(flow::g_runtime->externalAssets, -pageId - 1, widgetCursor);
 	} else {
-	    widgetCursor.assets = g_mainAssets;
-		if (g_mainAssets->flowDefinition) {
-			widgetCursor.flowState = flow::getPageFlowState(g_mainAssets, pageId - 1, widgetCursor);
+	    widgetCursor.assets = flow::g_runtime->mainAssets;
+		if (flow::g_runtime->mainAssets->flowDefinition) {
+			widgetCursor.flowState = flow::getPageFlowState(flow::g_runtime->mainAssets, pageId - 1, widgetCursor);
 		}
     }
 	return getPageAsset(pageId);
 }
 const gui::Style *getStyle(int styleID) {
 	if (styleID > 0) {
-		return g_mainAssets->styles[styleID - 1];
+		return flow::g_runtime->mainAssets->styles[styleID - 1];
 	} else if (styleID < 0) {
-		if (g_externalAssets == nullptr) {
+		if (flow::g_runtime->externalAssets == nullptr) {
 			return getStyle(STYLE_ID_DEFAULT);
 		}
-		return g_externalAssets->styles[-styleID - 1];
+		return flow::g_runtime->externalAssets->styles[-styleID - 1];
 	}
 	return getStyle(STYLE_ID_DEFAULT);
 }
 const gui::FontData *getFontData(int fontID) {
 	if (fontID > 0) {
-		return g_mainAssets->fonts[fontID - 1];
+		return flow::g_runtime->mainAssets->fonts[fontID - 1];
 	} else if (fontID < 0) {
-		if (g_externalAssets == nullptr) {
+		if (flow::g_runtime->externalAssets == nullptr) {
 			return nullptr;
 		}
-		return g_externalAssets->fonts[-fontID - 1];
+		return flow::g_runtime->externalAssets->fonts[-fontID - 1];
 	}
 	return nullptr;
 }
 const gui::Bitmap *getBitmap(int bitmapID) {
 	if (bitmapID > 0) {
-		return g_mainAssets->bitmaps[bitmapID - 1];
+		return flow::g_runtime->mainAssets->bitmaps[bitmapID - 1];
 	} else if (bitmapID < 0) {
-		if (g_externalAssets == nullptr) {
+		if (flow::g_runtime->externalAssets == nullptr) {
 			return nullptr;
 		}
-		return g_externalAssets->bitmaps[-bitmapID - 1];
+		return flow::g_runtime->externalAssets->bitmaps[-bitmapID - 1];
 	}
 	return nullptr;
 }
 const int getBitmapIdByName(const char *bitmapName) {
-    for (uint32_t i = 0; i < g_mainAssets->bitmaps.count; i++) {
-		if (strcmp(g_mainAssets->bitmaps[i]->name, bitmapName) == 0) {
-            return i + 1;
-        }
-	}
-    return 0;
+    return findAssetsName(flow::g_runtime->mainAssets, ASSETS_NAME_TABLE_BITMAPS, bitmapName) + 1;
 }
 #endif 
 int getThemesCount() {
-	return (int)g_mainAssets->colorsDefinition->themes.count;
+	return (int)flow::g_runtime->mainAssets->colorsDefinition->themes.count;
 }
 Theme *getTheme(int i) {
-    if (i < 0 || i >= (int)g_mainAssets->colorsDefinition->themes.count) {
+    if (i < 0 || i >= (int)flow::g_runtime->mainAssets->colorsDefinition->themes.count) {
         return nullptr;
     }
-    return g_mainAssets->colorsDefinition->themes[i];
+    return flow::g_runtime->mainAssets->colorsDefinition->themes[i];
 }
 const char *getThemeName(int i) {
     auto theme = getTheme(i);
@@ -453,7 +872,7 @@ const uint16_t *getThemeColors(int themeIndex) {
 	return static_cast<uint16_t *>(theme->colors.items);
 }
 const uint16_t *getColors() {
-	return static_cast<uint16_t *>(g_mainAssets->colorsDefinition->colors.items);
+	return static_cast<uint16_t *>(flow::g_runtime->mainAssets->colorsDefinition->colors.items);
 }
 int getExternalAssetsMainPageId() {
 	return -1;
@@ -476,12 +895,11 @@ int16_t getDataIdFromName(const WidgetCursor &widgetCursor, const char *name) {
 	if (!widgetCursor.assets) {
 		return 0;
 	}
-	for (uint32_t i = 0; i < widgetCursor.assets->variableNames.count; i++) {
-		if (strcmp(widgetCursor.assets->variableNames[i], name) == 0) {
-			return -((int16_t)i + 1);
-		}
+	auto variableIndex = findAssetsName(widgetCursor.assets, ASSETS_NAME_TABLE_VARIABLES, name);
+	if (variableIndex == -1) {
+		return 0;
 	}
-	return 0;
+	return -((int16_t)variableIndex + 1);
 }
 #endif 
 } 
@@ -631,8 +1049,14 @@ uint8_t *allocBuffer(uint32_t size) {
 #if defined(__EMSCRIPTEN__)
 #include <sys/time.h>
 #endif
+#if defined(EEZ_PLATFORM_SIMULATOR)
+#include <chrono>
+#endif
+#if defined(EEZ_FOR_LVGL) && (defined(__unix__) || defined(__APPLE__))
+#include <time.h>
+#endif
 namespace eez {
-uint32_t millis() {
+static uint32_t readMillis() {
 #if defined(EEZ_PLATFORM_STM32)
 	return HAL_GetTick();
 #elif defined(__EMSCRIPTEN__)
@@ -653,6 +1077,48 @@ uint32_t millis() {
     #error "Missing millis implementation";
 #endif
 }
+static uint32_t readMicros() {
+#if defined(EEZ_PLATFORM_STM32)
+    uint32_t ms;
+    uint32_t ticks;
+    do {
+        ms = HAL_GetTick();
+        ticks = SysTick->VAL;
+    } while (ms != HAL_GetTick());
+    uint32_t load = SysTick->LOAD + 1;
+    return ms * 1000 + (load - ticks) * 1000 / load;
+#elif defined(__EMSCRIPTEN__)
+	return (uint32_t)(uint64_t)(emscripten_get_now() * 1000.0);
+#elif defined(EEZ_PLATFORM_SIMULATOR)
+    return (uint32_t)std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+#elif defined(EEZ_PLATFORM_ESP32)
+	return (uint32_t)esp_timer_get_time();
+#elif defined(EEZ_PLATFORM_PICO)
+    return (uint32_t)to_us_since_boot(get_absolute_time());
+#elif defined(EEZ_PLATFORM_RASPBERRY)
+    return CTimer::Get()->GetClockTicks();
+#elif defined(EEZ_FOR_LVGL) && (defined(__unix__) || defined(__APPLE__))
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint32_t)((uint64_t)ts.tv_sec * 1000000 + ts.tv_nsec / 1000);
+#elif defined(EEZ_FOR_LVGL)
+    return lv_tick_get() * 1000;
+#else
+    #error "Missing micros implementation";
+#endif
+}
+uint32_t millis() {
+    if (flow::g_runtime->traceMode != flow::TRACE_MODE_OFF) {
+        return flow::traceClock(flow::TRACE_EVENT_MILLIS, readMillis);
+    }
+    return readMillis();
+}
+uint32_t micros() {
+    if (flow::g_runtime->traceMode != flow::TRACE_MODE_OFF) {
+        return flow::traceClock(flow::TRACE_EVENT_MICROS, readMicros);
+    }
+    return readMicros();
+}
 } 
 // -----------------------------------------------------------------------------
 // core/unit.cpp
@@ -934,6 +1400,14 @@ Unit getSmallestUnit(Unit unit, float min, float precision) {
 #if defined(EEZ_PLATFORM_STM32) && !defined(EEZ_FOR_LVGL)
 #include <crc.h>
 #endif
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define EEZ_CRC32_PCLMUL 1
+#include <cpuid.h>
+#include <immintrin.h>
+#elif defined(__ARM_FEATURE_CRC32)
+#define EEZ_CRC32_ARMV8 1
+#include <arm_acle.h>
+#endif
 namespace eez {
 float remap(float x, float x1, float y1, float x2, float y2) {
     return y1 + (x - x1) * (y2 - y1) / (x2 - x1);
@@ -1073,12 +1547,7 @@ void stringAppendLoad(char *str, size_t maxStrLength, float value) {
         snprintf(str + n, maxStrLength - n, "%g Mohm", value / 1000000);
     }
 }
-#if defined(EEZ_PLATFORM_STM32) && !defined(EEZ_FOR_LVGL)
-uint32_t crc32(const uint8_t *mem_block, size_t block_size) {
-	return HAL_CRC_Calculate(&hcrc, (uint32_t *)mem_block, block_size);
-}
-#else
-uint32_t crc32(const uint8_t *mem_block, size_t block_size) {
+uint32_t crc32Bitwise(const uint8_t *mem_block, size_t block_size) {
     uint32_t crc = 0xFFFFFFFF;
     for (size_t i = 0; i < block_size; ++i) {
         uint32_t byte = mem_block[i]; 
@@ -1090,6 +1559,164 @@ uint32_t crc32(const uint8_t *mem_block, size_t block_size) {
     }
     return ~crc;
 }
+#if defined(EEZ_PLATFORM_STM32) && !defined(EEZ_FOR_LVGL)
+uint32_t crc32(const uint8_t *mem_block, size_t block_size) {
+	return HAL_CRC_Calculate(&hcrc, (uint32_t *)mem_block, block_size);
+}
+#else
+static uint32_t g_crc32Tables[8][256];
+static void initCrc32Tables() {
+    for (uint32_t i = 0; i < 256; i++) {
+        uint32_t crc = i;
+        for (int j = 0; j < 8; j++) {
+            crc = (crc >> 1) ^ (0xEDB88320 & -(crc & 1));
+        }
+        g_crc32Tables[0][i] = crc;
+    }
+    for (uint32_t i = 0; i < 256; i++) {
+        for (int t = 1; t < 8; t++) {
+            g_crc32Tables[t][i] = (g_crc32Tables[t - 1][i] >> 8) ^ g_crc32Tables[0][g_crc32Tables[t - 1][i] & 0xFF];
+        }
+    }
+}
+static uint32_t crc32SlicingBy8(uint32_t crc, const uint8_t *mem_block, size_t block_size) {
+    while (block_size > 0 && ((uintptr_t)mem_block & 3) != 0) {
+        crc = (crc >> 8) ^ g_crc32Tables[0][(crc ^ *mem_block++) & 0xFF];
+        block_size--;
+    }
+    while (block_size >= 8) {
+        uint32_t one = (mem_block[0] | (mem_block[1] << 8) | (mem_block[2] << 16) | ((uint32_t)mem_block[3] << 24)) ^ crc;
+        uint32_t two = mem_block[4] | (mem_block[5] << 8) | (mem_block[6] << 16) | ((uint32_t)mem_block[7] << 24);
+        crc = g_crc32Tables[7][one & 0xFF] ^ g_crc32Tables[6][(one >> 8) & 0xFF] ^
+            g_crc32Tables[5][(one >> 16) & 0xFF] ^ g_crc32Tables[4][one >> 24] ^
+            g_crc32Tables[3][two & 0xFF] ^ g_crc32Tables[2][(two >> 8) & 0xFF] ^
+            g_crc32Tables[1][(two >> 16) & 0xFF] ^ g_crc32Tables[0][two >> 24];
+        mem_block += 8;
+        block_size -= 8;
+    }
+    while (block_size-- > 0) {
+        crc = (crc >> 8) ^ g_crc32Tables[0][(crc ^ *mem_block++) & 0xFF];
+    }
+    return crc;
+}
+#if defined(EEZ_CRC32_PCLMUL)
+__attribute__((target("pclmul,sse4.1")))
+static uint32_t crc32Pclmul(uint32_t crc, const uint8_t *mem_block, size_t block_size) {
+    alignas(16) static const uint64_t k1k2[] = { 0x0154442bd4, 0x01c6e41596 };
+    alignas(16) static const uint64_t k3k4[] = { 0x01751997d0, 0x00ccaa009e };
+    alignas(16) static const uint64_t k5k0[] = { 0x0163cd6124, 0x0000000000 };
+    alignas(16) static const uint64_t poly[] = { 0x01db710641, 0x01f7011641 };
+    if (block_size < 64) {
+        return crc32SlicingBy8(crc, mem_block, block_size);
+    }
+    size_t tail = block_size & 15;
+    block_size -= tail;
+    __m128i x0, x1, x2, x3, x4, x5, x6, x7, x8;
+    x1 = _mm_loadu_si128((const __m128i *)(mem_block + 0x00));
+    x2 = _mm_loadu_si128((const __m128i *)(mem_block + 0x10));
+    x3 = _mm_loadu_si128((const __m128i *)(mem_block + 0x20));
+    x4 = _mm_loadu_si128((const __m128i *)(mem_block + 0x30));
+    x1 = _mm_xor_si128(x1, _mm_cvtsi32_si128(crc));
+    x0 = _mm_load_si128((const __m128i *)k1k2);
+    mem_block += 64;
+    block_size -= 64;
+    while (block_size >= 64) {
+        x5 = _mm_clmulepi64_si128(x1, x0, 0x00);
+        x6 = _mm_clmulepi64_si128(x2, x0, 0x00);
+        x7 = _mm_clmulepi64_si128(x3, x0, 0x00);
+        x8 = _mm_clmulepi64_si128(x4, x0, 0x00);
+        x1 = _mm_clmulepi64_si128(x1, x0, 0x11);
+        x2 = _mm_clmulepi64_si128(x2, x0, 0x11);
+        x3 = _mm_clmulepi64_si128(x3, x0, 0x11);
+        x4 = _mm_clmulepi64_si128(x4, x0, 0x11);
+        x1 = _mm_xor_si128(_mm_xor_si128(x1, x5), _mm_loadu_si128((const __m128i *)(mem_block + 0x00)));
+        x2 = _mm_xor_si128(_mm_xor_si128(x2, x6), _mm_loadu_si128((const __m128i *)(mem_block + 0x10)));
+        x3 = _mm_xor_si128(_mm_xor_si128(x3, x7), _mm_loadu_si128((const __m128i *)(mem_block + 0x20)));
+        x4 = _mm_xor_si128(_mm_xor_si128(x4, x8), _mm_loadu_si128((const __m128i *)(mem_block + 0x30)));
+        mem_block += 64;
+        block_size -= 64;
+    }
+    x0 = _mm_load_si128((const __m128i *)k3k4);
+    x5 = _mm_clmulepi64_si128(x1, x0, 0x00);
+    x1 = _mm_clmulepi64_si128(x1, x0, 0x11);
+    x1 = _mm_xor_si128(_mm_xor_si128(x1, x2), x5);
+    x5 = _mm_clmulepi64_si128(x1, x0, 0x00);
+    x1 = _mm_clmulepi64_si128(x1, x0, 0x11);
+    x1 = _mm_xor_si128(_mm_xor_si128(x1, x3), x5);
+    x5 = _mm_clmulepi64_si128(x1, x0, 0x00);
+    x1 = _mm_clmulepi64_si128(x1, x0, 0x11);
+    x1 = _mm_xor_si128(_mm_xor_si128(x1, x4), x5);
+    while (block_size >= 16) {
+        x2 = _mm_loadu_si128((const __m128i *)mem_block);
+        x5 = _mm_clmulepi64_si128(x1, x0, 0x00);
+        x1 = _mm_clmulepi64_si128(x1, x0, 0x11);
+        x1 = _mm_xor_si128(_mm_xor_si128(x1, x2), x5);
+        mem_block += 16;
+        block_size -= 16;
+    }
+    x2 = _mm_clmulepi64_si128(x1, x0, 0x10);
+    x3 = _mm_setr_epi32(~0, 0, ~0, 0);
+    x1 = _mm_srli_si128(x1, 8);
+    x1 = _mm_xor_si128(x1, x2);
+    x0 = _mm_loadl_epi64((const __m128i *)k5k0);
+    x2 = _mm_srli_si128(x1, 4);
+    x1 = _mm_and_si128(x1, x3);
+    x1 = _mm_clmulepi64_si128(x1, x0, 0x00);
+    x1 = _mm_xor_si128(x1, x2);
+    x0 = _mm_load_si128((const __m128i *)poly);
+    x2 = _mm_and_si128(x1, x3);
+    x2 = _mm_clmulepi64_si128(x2, x0, 0x10);
+    x2 = _mm_and_si128(x2, x3);
+    x2 = _mm_clmulepi64_si128(x2, x0, 0x00);
+    x1 = _mm_xor_si128(x1, x2);
+    crc = _mm_extract_epi32(x1, 1);
+    return crc32SlicingBy8(crc, mem_block, tail);
+}
+static bool hasPclmul() {
+    unsigned int eax, ebx, ecx, edx;
+    return __get_cpuid(1, &eax, &ebx, &ecx, &edx) && (ecx & bit_PCLMUL) && (ecx & bit_SSE4_1);
+}
+#endif
+#if defined(EEZ_CRC32_ARMV8)
+static uint32_t crc32Armv8(uint32_t crc, const uint8_t *mem_block, size_t block_size) {
+    while (block_size > 0 && ((uintptr_t)mem_block & 7) != 0) {
+        crc = __crc32b(crc, *mem_block++);
+        block_size--;
+    }
+    while (block_size >= 8) {
+        crc = __crc32d(crc, *(const uint64_t *)mem_block);
+        mem_block += 8;
+        block_size -= 8;
+    }
+    while (block_size-- > 0) {
+        crc = __crc32b(crc, *mem_block++);
+    }
+    return crc;
+}
+#endif
+typedef uint32_t (*Crc32Function)(uint32_t crc, const uint8_t *mem_block, size_t block_size);
+static Crc32Function g_crc32Function;
+void crc32UsePortable(bool portable) {
+    if (!g_crc32Function) {
+        initCrc32Tables();
+    }
+    g_crc32Function = crc32SlicingBy8;
+    if (!portable) {
+#if defined(EEZ_CRC32_PCLMUL)
+        if (hasPclmul()) {
+            g_crc32Function = crc32Pclmul;
+        }
+#elif defined(EEZ_CRC32_ARMV8)
+        g_crc32Function = crc32Armv8;
+#endif
+    }
+}
+uint32_t crc32(const uint8_t *mem_block, size_t block_size) {
+    if (!g_crc32Function) {
+        crc32UsePortable(false);
+    }
+    return ~g_crc32Function(0xFFFFFFFF, mem_block, block_size);
+}
 #endif
 uint8_t toBCD(uint8_t bin) {
     return ((bin / 10) << 4) | (bin % 10);
@@ -2052,10 +2679,20 @@ const char *WIDGET_value_type_name(const Value &value) {
     return "widget";
 }
 bool compare_JSON_value(const Value &a, const Value &b) {
+#if defined(EEZ_DASHBOARD_API)
     return a.type == b.type && a.int32Value == b.int32Value;
+#else
+    return a.type == b.type &&
+        ((flow::JsonRef *)a.refValue)->document == ((flow::JsonRef *)b.refValue)->document &&
+        ((flow::JsonRef *)a.refValue)->node == ((flow::JsonRef *)b.refValue)->node;
+#endif
 }
 void JSON_value_to_text(const Value &value, char *text, int count) {
+#if defined(EEZ_DASHBOARD_API)
     snprintf(text, count, "json (id=%d)", value.getInt());
+#else
+    flow::jsonValueToText(value, text, count);
+#endif
 }
 const char *JSON_value_type_name(const Value &value) {
     return "json";
@@ -2730,6 +3367,20 @@ Value Value::makeStringRef(const char *str, int len, uint32_t id) {
     value.refValue = stringRef;
 	return value;
 }
+Value Value::makeStringSliceRef(const Value &bufferValue, char *str, uint32_t id) {
+    auto stringSliceRef = ObjectAllocator<StringSliceRef>::allocate(id);
+	if (stringSliceRef == nullptr) {
+		return Value(0, VALUE_TYPE_NULL);
+	}
+    stringSliceRef->str = str;
+    stringSliceRef->bufferValue = bufferValue;
+    stringSliceRef->refCounter = 1;
+    Value value;
+    value.type = VALUE_TYPE_STRING_REF;
+    value.options = VALUE_OPTIONS_REF;
+    value.refValue = stringSliceRef;
+	return value;
+}
 Value Value::concatenateString(const Value &str1, const Value &str2) {
     auto stringRef = ObjectAllocator<StringRef>::allocate(0xbab14c6a);;
 	if (stringRef == nullptr) {
@@ -2901,7 +3552,7 @@ Value Value::clone() {
 }
 #if defined(EEZ_OPTION_GUI)
 #if !EEZ_OPTION_GUI
-Value getVar(int16_t id) {
+static Value readVar(int16_t id) {
     auto native_var = native_vars[id];
     if (native_var.type == NATIVE_VAR_TYPE_INTEGER) {
         auto get = (int32_t (*)())native_var.get;
@@ -2925,6 +3576,12 @@ Value getVar(int16_t id) {
     }
     return Value();
 }
+Value getVar(int16_t id) {
+    if (flow::g_runtime->traceMode != flow::TRACE_MODE_OFF) {
+        return flow::traceNativeVariable(id, readVar);
+    }
+    return readVar(id);
+}
 void setVar(int16_t id, const Value& value) {
     auto native_var = native_vars[id];
     if (native_var.type == NATIVE_VAR_TYPE_INTEGER) {
@@ -2952,51 +3609,553 @@ void setVar(int16_t id, const Value& value) {
 #endif 
 } 
 // -----------------------------------------------------------------------------
-// flow/components.cpp
+// flow/checkpoint.cpp
 // -----------------------------------------------------------------------------
-#include <stdio.h>
-#include <math.h>
-#if defined(EEZ_DASHBOARD_API)
-#endif
+#include <stdlib.h>
+#include <string.h>
 namespace eez {
 namespace flow {
-void executeStartComponent(FlowState *flowState, unsigned componentIndex);
-void executeEndComponent(FlowState *flowState, unsigned componentIndex);
-void executeInputComponent(FlowState *flowState, unsigned componentIndex);
-void executeOutputComponent(FlowState *flowState, unsigned componentIndex);
-void executeWatchVariableComponent(FlowState *flowState, unsigned componentIndex);
-void executeEvalExprComponent(FlowState *flowState, unsigned componentIndex);
-void executeSetVariableComponent(FlowState *flowState, unsigned componentIndex);
-void executeSwitchComponent(FlowState *flowState, unsigned componentIndex);
-void executeCompareComponent(FlowState *flowState, unsigned componentIndex);
-void executeIsTrueComponent(FlowState *flowState, unsigned componentIndex);
-void executeConstantComponent(FlowState *flowState, unsigned componentIndex);
-void executeLogComponent(FlowState *flowState, unsigned componentIndex);
-void executeCallActionComponent(FlowState *flowState, unsigned componentIndex);
-void executeDelayComponent(FlowState *flowState, unsigned componentIndex);
-void executeErrorComponent(FlowState *flowState, unsigned componentIndex);
-void executeCatchErrorComponent(FlowState *flowState, unsigned componentIndex);
-void executeCounterComponent(FlowState *flowState, unsigned componentIndex);
-void executeLoopComponent(FlowState *flowState, unsigned componentIndex);
-void executeShowPageComponent(FlowState *flowState, unsigned componentIndex);
-#if EEZ_OPTION_GUI
-void executeShowMessageBoxComponent(FlowState *flowState, unsigned componentIndex);
-void executeShowKeyboardComponent(FlowState *flowState, unsigned componentIndex);
-void executeShowKeypadComponent(FlowState *flowState, unsigned componentIndex);
-void executeSetPageDirectionComponent(FlowState *flowState, unsigned componentIndex);
-void executeOverrideStyleComponent(FlowState *flowState, unsigned componentIndex);
-#endif
-void executeSelectLanguageComponent(FlowState *flowState, unsigned componentIndex);
-void executeAnimateComponent(FlowState *flowState, unsigned componentIndex);
-void executeNoopComponent(FlowState *flowState, unsigned componentIndex);
-void executeOnEventComponent(FlowState *flowState, unsigned componentIndex);
-void executeLVGLComponent(FlowState *flowState, unsigned componentIndex);
-void executeLVGLUserWidgetComponent(FlowState *flowState, unsigned componentIndex);
-void executeSortArrayComponent(FlowState *flowState, unsigned componentIndex);
-void executeTestAndSetComponent(FlowState *flowState, unsigned componentIndex);
-#if EEZ_OPTION_GUI
-void executeUserWidgetWidgetComponent(FlowState *flowState, unsigned componentIndex);
-void executeLineChartWidgetComponent(FlowState *flowState, unsigned componentIndex);
+void checkpointWrite(CheckpointWriter &writer, const void *data, size_t size) {
+    if (writer.buffer && writer.size + size <= writer.bufferSize) {
+        memcpy(writer.buffer + writer.size, data, size);
+    }
+    writer.size += size;
+}
+bool checkpointRead(CheckpointReader &reader, void *data, size_t size) {
+    if (reader.offset + size > reader.size) {
+        return false;
+    }
+    memcpy(data, reader.data + reader.offset, size);
+    reader.offset += size;
+    return true;
+}
+static bool isCheckpointScalarType(uint8_t type) {
+    switch (type) {
+    case VALUE_TYPE_UNDEFINED:
+    case VALUE_TYPE_NULL:
+    case VALUE_TYPE_BOOLEAN:
+    case VALUE_TYPE_INT8:
+    case VALUE_TYPE_UINT8:
+    case VALUE_TYPE_INT16:
+    case VALUE_TYPE_UINT16:
+    case VALUE_TYPE_INT32:
+    case VALUE_TYPE_UINT32:
+    case VALUE_TYPE_INT64:
+    case VALUE_TYPE_UINT64:
+    case VALUE_TYPE_FLOAT:
+    case VALUE_TYPE_DOUBLE:
+    case VALUE_TYPE_DATE:
+    case VALUE_TYPE_ENUM:
+        return true;
+    default:
+        return false;
+    }
+}
+bool checkpointWriteValue(CheckpointWriter &writer, const Value &value) {
+    if (isCheckpointScalarType(value.type)) {
+        checkpointWrite(writer, &value, sizeof(Value));
+        return true;
+    }
+    if (value.isString()) {
+        uint8_t type = VALUE_TYPE_STRING_REF;
+        auto str = value.getString();
+        uint32_t len = str ? strlen(str) : 0;
+        checkpointWrite(writer, &type, sizeof(type));
+        checkpointWrite(writer, &len, sizeof(len));
+        checkpointWrite(writer, str, len);
+        return true;
+    }
+    if (value.isArray()) {
+        uint8_t type = VALUE_TYPE_ARRAY_REF;
+        auto array = value.getArray();
+        checkpointWrite(writer, &type, sizeof(type));
+        checkpointWrite(writer, &array->arrayType, sizeof(array->arrayType));
+        checkpointWrite(writer, &array->arraySize, sizeof(array->arraySize));
+        for (uint32_t elementIndex = 0; elementIndex < array->arraySize; elementIndex++) {
+            if (!checkpointWriteValue(writer, array->values[elementIndex])) {
+                return false;
+            }
+        }
+        return true;
+    }
+    if (value.type == VALUE_TYPE_BLOB_REF) {
+        uint8_t type = VALUE_TYPE_BLOB_REF;
+        auto blobRef = (BlobRef *)value.refValue;
+        checkpointWrite(writer, &type, sizeof(type));
+        checkpointWrite(writer, &blobRef->len, sizeof(blobRef->len));
+        checkpointWrite(writer, blobRef->blob, blobRef->len);
+        return true;
+    }
+    return false;
+}
+bool checkpointReadValue(CheckpointReader &reader, Value &value) {
+    if (reader.offset >= reader.size) {
+        return false;
+    }
+    uint8_t type = reader.data[reader.offset];
+    if (isCheckpointScalarType(type)) {
+        Value scalarValue;
+        if (!checkpointRead(reader, &scalarValue, sizeof(Value))) {
+            return false;
+        }
+        value = scalarValue;
+        return true;
+    }
+    reader.offset++;
+    if (type == VALUE_TYPE_STRING_REF || type == VALUE_TYPE_BLOB_REF) {
+        uint32_t len;
+        if (!checkpointRead(reader, &len, sizeof(len)) || reader.offset + len > reader.size) {
+            return false;
+        }
+        auto data = reader.data + reader.offset;
+        reader.offset += len;
+        if (type == VALUE_TYPE_STRING_REF) {
+            value = Value::makeStringRef((const char *)data, len, 0x5c1e0a01);
+        } else {
+            value = Value::makeBlobRef(data, len, 0x5c1e0a02);
+        }
+        return true;
+    }
+    if (type == VALUE_TYPE_ARRAY_REF) {
+        uint32_t arrayType;
+        uint32_t arraySize;
+        if (!checkpointRead(reader, &arrayType, sizeof(arrayType)) || !checkpointRead(reader, &arraySize, sizeof(arraySize))) {
+            return false;
+        }
+        if (arraySize > reader.size - reader.offset) {
+            return false;
+        }
+        auto arrayValue = Value::makeArrayRef(arraySize, arrayType, 0x5c1e0a03);
+        auto array = arrayValue.getArray();
+        for (uint32_t elementIndex = 0; elementIndex < arraySize; elementIndex++) {
+            if (!checkpointReadValue(reader, array->values[elementIndex])) {
+                return false;
+            }
+        }
+        value = arrayValue;
+        return true;
+    }
+    return false;
+}
+struct CheckpointHeader {
+    uint32_t magic;
+    uint16_t version;
+    uint16_t valueSize;
+    uint32_t numFlows;
+    uint32_t numGlobalVariables;
+    uint32_t flowDefinitionHash;
+    uint32_t numFlowStates;
+};
+struct CheckpointFlowState {
+    int32_t parentId;
+    int32_t parentComponentIndex;
+    uint16_t flowIndex;
+    uint8_t isAction;
+    uint8_t error;
+    float timelinePosition;
+    int32_t lvglWidgetStartIndex;
+    uint16_t numComponentExecutionStates;
+};
+struct CheckpointFlowStateId {
+    FlowState *flowState;
+    uint32_t id;
+};
+static uint32_t hashCheckpointWord(uint32_t hash, uint32_t word) {
+    for (unsigned i = 0; i < 4; i++) {
+        hash = (hash ^ ((word >> (8 * i)) & 0xFF)) * 16777619u;
+    }
+    return hash;
+}
+uint32_t getFlowDefinitionHash(FlowDefinition *flowDefinition) {
+    uint32_t hash = 2166136261u;
+    hash = hashCheckpointWord(hash, flowDefinition->flows.count);
+    hash = hashCheckpointWord(hash, flowDefinition->globalVariables.count);
+    for (uint32_t flowIndex = 0; flowIndex < flowDefinition->flows.count; flowIndex++) {
+        auto flow = flowDefinition->flows[flowIndex];
+        hash = hashCheckpointWord(hash, flow->components.count);
+        hash = hashCheckpointWord(hash, flow->componentInputs.count);
+        hash = hashCheckpointWord(hash, flow->localVariables.count);
+        for (uint32_t componentIndex = 0; componentIndex < flow->components.count; componentIndex++) {
+            hash = hashCheckpointWord(hash, flow->components[componentIndex]->type);
+        }
+    }
+    return hash;
+}
+static void getCheckpointHeader(CheckpointHeader &header, FlowDefinition *flowDefinition) {
+    memset(&header, 0, sizeof(header));
+    header.magic = CHECKPOINT_MAGIC;
+    header.version = CHECKPOINT_VERSION;
+    header.valueSize = sizeof(Value);
+    header.numFlows = flowDefinition->flows.count;
+    header.numGlobalVariables = flowDefinition->globalVariables.count;
+    header.flowDefinitionHash = getFlowDefinitionHash(flowDefinition);
+}
+static bool saveComponentExecutionState(CheckpointWriter &writer, FlowState *flowState, unsigned componentIndex) {
+    switch (flowState->flow->components[componentIndex]->type) {
+    case defs_v3::COMPONENT_TYPE_CATCH_ERROR_ACTION:
+        return saveCatchErrorComponentExecutionState(writer, flowState, componentIndex);
+    case defs_v3::COMPONENT_TYPE_COUNTER_ACTION:
+        return saveCounterComponentExecutionState(writer, flowState, componentIndex);
+    case defs_v3::COMPONENT_TYPE_DELAY_ACTION:
+        return saveDelayComponentExecutionState(writer, flowState, componentIndex);
+    default:
+        return false;
+    }
+}
+static bool restoreComponentExecutionState(CheckpointReader &reader, FlowState *flowState, unsigned componentIndex) {
+    switch (flowState->flow->components[componentIndex]->type) {
+    case defs_v3::COMPONENT_TYPE_CATCH_ERROR_ACTION:
+        return restoreCatchErrorComponentExecutionState(reader, flowState, componentIndex);
+    case defs_v3::COMPONENT_TYPE_COUNTER_ACTION:
+        return restoreCounterComponentExecutionState(reader, flowState, componentIndex);
+    case defs_v3::COMPONENT_TYPE_DELAY_ACTION:
+        return restoreDelayComponentExecutionState(reader, flowState, componentIndex);
+    default:
+        return false;
+    }
+}
+static uint32_t countFlowStates(FlowState *flowState) {
+    uint32_t numFlowStates = 0;
+    for (; flowState; flowState = flowState->nextSibling) {
+        numFlowStates += 1 + countFlowStates(flowState->firstChild);
+    }
+    return numFlowStates;
+}
+static bool saveFlowStates(CheckpointWriter &writer, FlowState *flowState, int32_t parentId, CheckpointFlowStateId *flowStateIds, uint32_t &numFlowStateIds) {
+    for (; flowState; flowState = flowState->nextSibling) {
+        if (flowState->assets != g_runtime->mainAssets) {
+            return false;
+        }
+        auto flow = flowState->flow;
+        CheckpointFlowState checkpointFlowState;
+        memset(&checkpointFlowState, 0, sizeof(checkpointFlowState));
+        checkpointFlowState.parentId = parentId;
+        checkpointFlowState.parentComponentIndex = flowState->parentComponentIndex;
+        checkpointFlowState.flowIndex = flowState->flowIndex;
+        checkpointFlowState.isAction = flowState->isAction ? 1 : 0;
+        checkpointFlowState.error = flowState->error ? 1 : 0;
+        checkpointFlowState.timelinePosition = flowState->timelinePosition;
+#if defined(EEZ_FOR_LVGL)
+        checkpointFlowState.lvglWidgetStartIndex = flowState->lvglWidgetStartIndex;
+#endif
+        for (unsigned i = 0; i < flow->components.count; i++) {
+            if (flowState->componenentAsyncStates[i]) {
+                return false;
+            }
+            if (flowState->componenentExecutionStates[i]) {
+                checkpointFlowState.numComponentExecutionStates++;
+            }
+        }
+        checkpointWrite(writer, &checkpointFlowState, sizeof(checkpointFlowState));
+        if (!checkpointWriteValue(writer, flowState->inputValue)) {
+            return false;
+        }
+        auto nValues = flow->componentInputs.count + flow->localVariables.count;
+        for (unsigned i = 0; i < nValues; i++) {
+            if (!checkpointWriteValue(writer, flowState->values[i])) {
+                return false;
+            }
+        }
+        checkpointWrite(writer, flowState->componentInputCounters, flow->components.count * sizeof(ComponentInputCounters));
+        for (unsigned i = 0; i < flow->components.count; i++) {
+            if (flowState->componenentExecutionStates[i]) {
+                uint16_t componentIndex = i;
+                checkpointWrite(writer, &componentIndex, sizeof(componentIndex));
+                if (!saveComponentExecutionState(writer, flowState, i)) {
+                    return false;
+                }
+            }
+        }
+        auto id = numFlowStateIds++;
+        flowStateIds[id].flowState = flowState;
+        flowStateIds[id].id = id;
+        if (!saveFlowStates(writer, flowState->firstChild, id, flowStateIds, numFlowStateIds)) {
+            return false;
+        }
+    }
+    return true;
+}
+static int compareCheckpointFlowStateIds(const void *a, const void *b) {
+    auto flowStateA = ((const CheckpointFlowStateId *)a)->flowState;
+    auto flowStateB = ((const CheckpointFlowStateId *)b)->flowState;
+    return flowStateA < flowStateB ? -1 : flowStateA > flowStateB ? 1 : 0;
+}
+static bool saveQueue(CheckpointWriter &writer, CheckpointFlowStateId *flowStateIds, uint32_t numFlowStateIds) {
+    auto runtime = g_runtime;
+    qsort(flowStateIds, numFlowStateIds, sizeof(CheckpointFlowStateId), compareCheckpointFlowStateIds);
+    for (unsigned laneIndex = 0; laneIndex < QUEUE_NUM_LANES; laneIndex++) {
+        auto &lane = runtime->lanes[laneIndex];
+        uint32_t numTasks = lane.size;
+        checkpointWrite(writer, &numTasks, sizeof(numTasks));
+        auto chunk = lane.headChunk;
+        auto taskIndex = lane.headIndex;
+        for (uint32_t i = 0; i < numTasks; i++) {
+            if (taskIndex == QUEUE_CHUNK_SIZE) {
+                chunk = chunk->next;
+                taskIndex = 0;
+            }
+            auto &task = chunk->tasks[taskIndex++];
+            CheckpointFlowStateId key;
+            key.flowState = task.flowState;
+            auto flowStateId = (CheckpointFlowStateId *)bsearch(&key, flowStateIds, numFlowStateIds, sizeof(CheckpointFlowStateId), compareCheckpointFlowStateIds);
+            if (!flowStateId) {
+                return false;
+            }
+            uint32_t id = flowStateId->id;
+            uint16_t componentIndex = task.componentIndex;
+            uint8_t continuousTask = task.continuousTask ? 1 : 0;
+            checkpointWrite(writer, &id, sizeof(id));
+            checkpointWrite(writer, &componentIndex, sizeof(componentIndex));
+            checkpointWrite(writer, &continuousTask, sizeof(continuousTask));
+        }
+    }
+    return true;
+}
+bool saveCheckpoint(uint8_t *buffer, size_t bufferSize, size_t &checkpointSize) {
+    auto runtime = g_runtime;
+    auto assets = runtime->mainAssets;
+    checkpointSize = 0;
+    if (!assets || isFlowStopped() || runtime->isStopping || runtime->inlineActionQueue || !isWatchListEmpty()) {
+        return false;
+    }
+#if EEZ_FLOW_PARALLEL_ACTIONS
+    if (runtime->numParallelActionsInFlight > 0) {
+        return false;
+    }
+#endif
+    auto flowDefinition = static_cast<FlowDefinition *>(assets->flowDefinition);
+    CheckpointWriter writer;
+    writer.buffer = buffer;
+    writer.bufferSize = bufferSize;
+    writer.size = 0;
+    CheckpointHeader header;
+    getCheckpointHeader(header, flowDefinition);
+    header.numFlowStates = countFlowStates(runtime->firstFlowState);
+    checkpointWrite(writer, &header, sizeof(header));
+    for (uint32_t i = 0; i < flowDefinition->globalVariables.count; i++) {
+        if (!checkpointWriteValue(writer, getGlobalVariable(assets, i))) {
+            return false;
+        }
+    }
+    CheckpointFlowStateId *flowStateIds = nullptr;
+    if (header.numFlowStates > 0) {
+        flowStateIds = (CheckpointFlowStateId *)alloc(header.numFlowStates * sizeof(CheckpointFlowStateId), 0x5c1e0a04);
+        if (!flowStateIds) {
+            return false;
+        }
+    }
+    uint32_t numFlowStateIds = 0;
+    bool result = saveFlowStates(writer, runtime->firstFlowState, -1, flowStateIds, numFlowStateIds) &&
+        saveQueue(writer, flowStateIds, numFlowStateIds);
+    if (flowStateIds) {
+        free(flowStateIds);
+    }
+    checkpointSize = writer.size;
+    return result && buffer && writer.size <= bufferSize;
+}
+static void resetRuntimeForRestore() {
+    auto runtime = g_runtime;
+#if EEZ_FLOW_PARALLEL_ACTIONS
+    cancelParallelActions();
+#endif
+    freeAllChildrenFlowStates(runtime->firstFlowState);
+    runtime->firstFlowState = nullptr;
+    runtime->lastFlowState = nullptr;
+    queueReset();
+    timerWheelReset();
+    watchListReset();
+}
+static bool restoreFlowStates(CheckpointReader &reader, Assets *assets, uint32_t numFlowStates, FlowState **flowStates) {
+    auto flowDefinition = static_cast<FlowDefinition *>(assets->flowDefinition);
+    for (uint32_t id = 0; id < numFlowStates; id++) {
+        CheckpointFlowState checkpointFlowState;
+        Value inputValue;
+        if (!checkpointRead(reader, &checkpointFlowState, sizeof(checkpointFlowState)) || !checkpointReadValue(reader, inputValue)) {
+            return false;
+        }
+        if (checkpointFlowState.flowIndex >= flowDefinition->flows.count || checkpointFlowState.parentId >= (int32_t)id) {
+            return false;
+        }
+        auto parentFlowState = checkpointFlowState.parentId >= 0 ? flowStates[checkpointFlowState.parentId] : nullptr;
+        if (checkpointFlowState.parentComponentIndex >= 0 && (!parentFlowState || (uint32_t)checkpointFlowState.parentComponentIndex >= parentFlowState->flow->components.count)) {
+            return false;
+        }
+        auto flowState = initFlowState(assets, checkpointFlowState.flowIndex, parentFlowState, checkpointFlowState.parentComponentIndex, inputValue, false);
+        if (!flowState) {
+            return false;
+        }
+        flowStates[id] = flowState;
+        flowState->isAction = checkpointFlowState.isAction != 0;
+        flowState->error = checkpointFlowState.error != 0;
+        flowState->timelinePosition = checkpointFlowState.timelinePosition;
+#if defined(EEZ_FOR_LVGL)
+        flowState->lvglWidgetStartIndex = checkpointFlowState.lvglWidgetStartIndex;
+#endif
+        auto flow = flowState->flow;
+        auto nValues = flow->componentInputs.count + flow->localVariables.count;
+        for (unsigned i = 0; i < nValues; i++) {
+            if (!checkpointReadValue(reader, flowState->values[i])) {
+                return false;
+            }
+        }
+        if (!checkpointRead(reader, flowState->componentInputCounters, flow->components.count * sizeof(ComponentInputCounters))) {
+            return false;
+        }
+        for (unsigned i = 0; i < checkpointFlowState.numComponentExecutionStates; i++) {
+            uint16_t componentIndex;
+            if (!checkpointRead(reader, &componentIndex, sizeof(componentIndex)) || componentIndex >= flow->components.count) {
+                return false;
+            }
+            if (!restoreComponentExecutionState(reader, flowState, componentIndex)) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+static bool restoreQueue(CheckpointReader &reader, uint32_t numFlowStates, FlowState **flowStates) {
+    auto runtime = g_runtime;
+    for (unsigned laneIndex = 0; laneIndex < QUEUE_NUM_LANES; laneIndex++) {
+        uint32_t numTasks;
+        if (!checkpointRead(reader, &numTasks, sizeof(numTasks))) {
+            return false;
+        }
+        runtime->currentQueueLane = (QueueLane)laneIndex;
+        for (uint32_t i = 0; i < numTasks; i++) {
+            uint32_t id;
+            uint16_t componentIndex;
+            uint8_t continuousTask;
+            if (
+                !checkpointRead(reader, &id, sizeof(id)) ||
+                !checkpointRead(reader, &componentIndex, sizeof(componentIndex)) ||
+                !checkpointRead(reader, &continuousTask, sizeof(continuousTask)) ||
+                id >= numFlowStates ||
+                componentIndex >= flowStates[id]->flow->components.count
+            ) {
+                runtime->currentQueueLane = QUEUE_LANE_NORMAL;
+                return false;
+            }
+            if (!addToQueue(flowStates[id], componentIndex, -1, -1, -1, continuousTask != 0)) {
+                runtime->currentQueueLane = QUEUE_LANE_NORMAL;
+                return false;
+            }
+        }
+    }
+    runtime->currentQueueLane = QUEUE_LANE_NORMAL;
+    return true;
+}
+bool restoreCheckpoint(const uint8_t *data, size_t size) {
+    auto runtime = g_runtime;
+    auto assets = runtime->mainAssets;
+    if (!assets || !assets->flowDefinition || runtime->inlineActionQueue) {
+        return false;
+    }
+    auto flowDefinition = static_cast<FlowDefinition *>(assets->flowDefinition);
+    CheckpointReader reader;
+    reader.data = data;
+    reader.size = size;
+    reader.offset = 0;
+    CheckpointHeader header;
+    CheckpointHeader expectedHeader;
+    getCheckpointHeader(expectedHeader, flowDefinition);
+    if (
+        !checkpointRead(reader, &header, sizeof(header)) ||
+        header.magic != expectedHeader.magic ||
+        header.version != expectedHeader.version ||
+        header.valueSize != expectedHeader.valueSize ||
+        header.numFlows != expectedHeader.numFlows ||
+        header.numGlobalVariables != expectedHeader.numGlobalVariables ||
+        header.flowDefinitionHash != expectedHeader.flowDefinitionHash
+    ) {
+        return false;
+    }
+    resetRuntimeForRestore();
+    runtime->isStopped = false;
+    runtime->isStopping = false;
+    if (!runtime->globalVariables) {
+        initGlobalVariables(assets);
+    }
+    resetTickOverrunStats();
+    bool result = true;
+    for (uint32_t i = 0; i < header.numGlobalVariables; i++) {
+        Value value;
+        if (!checkpointReadValue(reader, value)) {
+            result = false;
+            break;
+        }
+        setGlobalVariable(assets, i, value);
+    }
+    if (result) {
+        scpiComponentInitHook();
+        onStarted(assets);
+        FlowState **flowStates = nullptr;
+        if (header.numFlowStates > 0) {
+            flowStates = (FlowState **)alloc(header.numFlowStates * sizeof(FlowState *), 0x5c1e0a05);
+        }
+        if (header.numFlowStates > 0 && !flowStates) {
+            result = false;
+        } else {
+            result = restoreFlowStates(reader, assets, header.numFlowStates, flowStates) &&
+                restoreQueue(reader, header.numFlowStates, flowStates);
+        }
+        if (flowStates) {
+            free(flowStates);
+        }
+    }
+    if (!result) {
+        resetRuntimeForRestore();
+        runtime->isStopped = true;
+    }
+    return result;
+}
+} 
+} 
+// -----------------------------------------------------------------------------
+// flow/components.cpp
+// -----------------------------------------------------------------------------
+#include <stdio.h>
+#include <math.h>
+#if defined(EEZ_DASHBOARD_API)
+#endif
+namespace eez {
+namespace flow {
+void executeStartComponent(FlowState *flowState, unsigned componentIndex);
+void executeEndComponent(FlowState *flowState, unsigned componentIndex);
+void executeInputComponent(FlowState *flowState, unsigned componentIndex);
+void executeOutputComponent(FlowState *flowState, unsigned componentIndex);
+void executeWatchVariableComponent(FlowState *flowState, unsigned componentIndex);
+void executeEvalExprComponent(FlowState *flowState, unsigned componentIndex);
+void executeSetVariableComponent(FlowState *flowState, unsigned componentIndex);
+void executeSwitchComponent(FlowState *flowState, unsigned componentIndex);
+void executeCompareComponent(FlowState *flowState, unsigned componentIndex);
+void executeIsTrueComponent(FlowState *flowState, unsigned componentIndex);
+void executeConstantComponent(FlowState *flowState, unsigned componentIndex);
+void executeLogComponent(FlowState *flowState, unsigned componentIndex);
+void executeCallActionComponent(FlowState *flowState, unsigned componentIndex);
+void executeDelayComponent(FlowState *flowState, unsigned componentIndex);
+void executeErrorComponent(FlowState *flowState, unsigned componentIndex);
+void executeCatchErrorComponent(FlowState *flowState, unsigned componentIndex);
+void executeCounterComponent(FlowState *flowState, unsigned componentIndex);
+void executeLoopComponent(FlowState *flowState, unsigned componentIndex);
+void executeShowPageComponent(FlowState *flowState, unsigned componentIndex);
+#if EEZ_OPTION_GUI
+void executeShowMessageBoxComponent(FlowState *flowState, unsigned componentIndex);
+void executeShowKeyboardComponent(FlowState *flowState, unsigned componentIndex);
+void executeShowKeypadComponent(FlowState *flowState, unsigned componentIndex);
+void executeSetPageDirectionComponent(FlowState *flowState, unsigned componentIndex);
+void executeOverrideStyleComponent(FlowState *flowState, unsigned componentIndex);
+#endif
+void executeSelectLanguageComponent(FlowState *flowState, unsigned componentIndex);
+void executeAnimateComponent(FlowState *flowState, unsigned componentIndex);
+void executeNoopComponent(FlowState *flowState, unsigned componentIndex);
+void executeOnEventComponent(FlowState *flowState, unsigned componentIndex);
+void executeLVGLComponent(FlowState *flowState, unsigned componentIndex);
+void executeLVGLUserWidgetComponent(FlowState *flowState, unsigned componentIndex);
+void executeSortArrayComponent(FlowState *flowState, unsigned componentIndex);
+void executeTestAndSetComponent(FlowState *flowState, unsigned componentIndex);
+#if EEZ_OPTION_GUI
+void executeUserWidgetWidgetComponent(FlowState *flowState, unsigned componentIndex);
+void executeLineChartWidgetComponent(FlowState *flowState, unsigned componentIndex);
 void executeRollerWidgetComponent(FlowState *flowState, unsigned componentIndex);
 #endif
 void executeMQTTInitComponent(FlowState *flowState, unsigned componentIndex);
@@ -3113,11 +4272,16 @@ using namespace eez::gui;
 #endif
 namespace eez {
 namespace flow {
+static const uint32_t ANIMATE_FRAME_PERIOD_MS = 5;
 struct AnimateComponenentExecutionState : public ComponenentExecutionState {
     float startPosition;
     float endPosition;
     float speed;
     uint32_t startTimestamp;
+    TimerWheelNode timer;
+    ~AnimateComponenentExecutionState() {
+        timerWheelCancel(&timer);
+    }
 };
 void executeAnimateComponent(FlowState *flowState, unsigned componentIndex) {
     FlowState *timelineFlowState = flowState;
@@ -3151,9 +4315,7 @@ void executeAnimateComponent(FlowState *flowState, unsigned componentIndex) {
             state->endPosition = to;
             state->speed = speed;
             state->startTimestamp = millis();
-            if (!addToQueue(flowState, componentIndex, -1, -1, -1, true)) {
-                return;
-            }
+            timerWheelSchedule(&state->timer, flowState, componentIndex, state->startTimestamp + ANIMATE_FRAME_PERIOD_MS);
         }
     } else {
         float currentTime;
@@ -3174,9 +4336,7 @@ void executeAnimateComponent(FlowState *flowState, unsigned componentIndex) {
             deallocateComponentExecutionState(flowState, componentIndex);
             propagateValueThroughSeqout(flowState, componentIndex);
         } else {
-            if (!addToQueue(flowState, componentIndex, -1, -1, -1, true)) {
-                return;
-            }
+            timerWheelSchedule(&state->timer, flowState, componentIndex, millis() + ANIMATE_FRAME_PERIOD_MS);
         }
     }
 }
@@ -3188,19 +4348,23 @@ void executeAnimateComponent(FlowState *flowState, unsigned componentIndex) {
 #include <stdio.h>
 namespace eez {
 namespace flow {
-FlowState *g_executeActionFlowState;
-unsigned g_executeActionComponentIndex;
 void executeCallAction(FlowState *flowState, unsigned componentIndex, int flowIndex, const Value& inputValue) {
 	if (flowIndex >= (int)flowState->flowDefinition->flows.count) {
-        g_executeActionFlowState = flowState;
-        g_executeActionComponentIndex = componentIndex;
+        g_runtime->executeActionFlowState = flowState;
+        g_runtime->executeActionComponentIndex = componentIndex;
 		executeActionFunction(flowIndex - flowState->flowDefinition->flows.count);
         if ((int)componentIndex != -1) {
 		    propagateValueThroughSeqout(flowState, componentIndex);
         }
 		return;
 	}
-	FlowState *actionFlowState = initActionFlowState(flowIndex, flowState, componentIndex, inputValue);
+#if EEZ_FLOW_PARALLEL_ACTIONS
+    if ((int)componentIndex != -1 && dispatchParallelAction(flowState, componentIndex, flowIndex)) {
+        return;
+    }
+#endif
+    bool isInlineAction = !g_runtime->debuggerIsConnected && isInlineActionFlow(flowState->assets, flowIndex);
+	FlowState *actionFlowState = initActionFlowState(flowIndex, flowState, componentIndex, inputValue, !isInlineAction);
     if ((int)componentIndex != -1) {
         auto component = flowState->flow->components[componentIndex];
         for (uint32_t i = 0; i < component->properties.count; i++) {
@@ -3222,6 +4386,10 @@ void executeCallAction(FlowState *flowState, unsigned componentIndex, int flowIn
             *propValuePtr = value;
             onValueChanged(propValuePtr);
         }
+    }
+    if (isInlineAction) {
+        executeInlineActionFlowState(actionFlowState);
+        return;
     }
 	if (canFreeFlowState(actionFlowState)) {
         freeFlowState(actionFlowState);
@@ -3252,6 +4420,19 @@ void executeCatchErrorComponent(FlowState *flowState, unsigned componentIndex) {
     deallocateComponentExecutionState(flowState, componentIndex);
 	propagateValueThroughSeqout(flowState, componentIndex);
 }
+bool saveCatchErrorComponentExecutionState(CheckpointWriter &writer, FlowState *flowState, unsigned componentIndex) {
+	auto catchErrorComponentExecutionState = (CatchErrorComponenentExecutionState *)flowState->componenentExecutionStates[componentIndex];
+    return checkpointWriteValue(writer, catchErrorComponentExecutionState->message);
+}
+bool restoreCatchErrorComponentExecutionState(CheckpointReader &reader, FlowState *flowState, unsigned componentIndex) {
+    Value message;
+    if (!checkpointReadValue(reader, message)) {
+        return false;
+    }
+	auto catchErrorComponentExecutionState = allocateComponentExecutionState<CatchErrorComponenentExecutionState>(flowState, componentIndex);
+    catchErrorComponentExecutionState->message = message;
+    return true;
+}
 } 
 } 
 // -----------------------------------------------------------------------------
@@ -3326,6 +4507,21 @@ void executeCounterComponent(FlowState *flowState, unsigned componentIndex) {
         propagateValue(flowState, componentIndex, 1);
     }
 }
+bool saveCounterComponentExecutionState(CheckpointWriter &writer, FlowState *flowState, unsigned componentIndex) {
+    auto counterComponenentExecutionState = (CounterComponenentExecutionState *)flowState->componenentExecutionStates[componentIndex];
+    int32_t counter = counterComponenentExecutionState->counter;
+    checkpointWrite(writer, &counter, sizeof(counter));
+    return true;
+}
+bool restoreCounterComponentExecutionState(CheckpointReader &reader, FlowState *flowState, unsigned componentIndex) {
+    int32_t counter;
+    if (!checkpointRead(reader, &counter, sizeof(counter))) {
+        return false;
+    }
+    auto counterComponenentExecutionState = allocateComponentExecutionState<CounterComponenentExecutionState>(flowState, componentIndex);
+    counterComponenentExecutionState->counter = counter;
+    return true;
+}
 } 
 } 
 // -----------------------------------------------------------------------------
@@ -3333,8 +4529,49 @@ void executeCounterComponent(FlowState *flowState, unsigned componentIndex) {
 // -----------------------------------------------------------------------------
 namespace eez {
 namespace flow {
+#if EEZ_FLOW_COROUTINES
+static ComponentCoroutine delayComponentCoroutine(FlowState *flowState, unsigned componentIndex, uint32_t waitUntil) {
+    co_await sleepUntil(waitUntil);
+    propagateValueThroughSeqout(flowState, componentIndex);
+}
+void executeDelayComponent(FlowState *flowState, unsigned componentIndex) {
+    if (flowState->componenentExecutionStates[componentIndex]) {
+        resumeComponentCoroutine(flowState, componentIndex);
+        return;
+    }
+    Value value;
+    if (!evalProperty(flowState, componentIndex, defs_v3::DELAY_ACTION_COMPONENT_PROPERTY_MILLISECONDS, value, "Failed to evaluate Milliseconds in Delay")) {
+        return;
+    }
+    double milliseconds = value.toDouble();
+    if (isNaN(milliseconds)) {
+        throwError(flowState, componentIndex, "Invalid Milliseconds value in Delay\n");
+        return;
+    }
+    startComponentCoroutine(flowState, componentIndex, delayComponentCoroutine(flowState, componentIndex, millis() + (uint32_t)floor(milliseconds)));
+}
+bool saveDelayComponentExecutionState(CheckpointWriter &writer, FlowState *flowState, unsigned componentIndex) {
+	auto delayComponentExecutionState = (ComponentCoroutineExecutionState *)flowState->componenentExecutionStates[componentIndex];
+    int32_t remaining = timerWheelIsScheduled(&delayComponentExecutionState->timer) ? (int32_t)(delayComponentExecutionState->timer.deadline - millis()) : 0;
+    uint32_t remainingMs = remaining > 0 ? (uint32_t)remaining : 0;
+    checkpointWrite(writer, &remainingMs, sizeof(remainingMs));
+    return true;
+}
+bool restoreDelayComponentExecutionState(CheckpointReader &reader, FlowState *flowState, unsigned componentIndex) {
+    uint32_t remainingMs;
+    if (!checkpointRead(reader, &remainingMs, sizeof(remainingMs))) {
+        return false;
+    }
+    startComponentCoroutine(flowState, componentIndex, delayComponentCoroutine(flowState, componentIndex, millis() + remainingMs));
+    return flowState->componenentExecutionStates[componentIndex] != nullptr;
+}
+#else
 struct DelayComponenentExecutionState : public ComponenentExecutionState {
 	uint32_t waitUntil;
+    TimerWheelNode timer;
+    ~DelayComponenentExecutionState() {
+        timerWheelCancel(&timer);
+    }
 };
 void executeDelayComponent(FlowState *flowState, unsigned componentIndex) {
 	auto delayComponentExecutionState = (DelayComponenentExecutionState *)flowState->componenentExecutionStates[componentIndex];
@@ -3351,26 +4588,40 @@ void executeDelayComponent(FlowState *flowState, unsigned componentIndex) {
 			throwError(flowState, componentIndex, "Invalid Milliseconds value in Delay\n");
 			return;
 		}
-		if (!addToQueue(flowState, componentIndex, -1, -1, -1, true)) {
-			return;
-		}
+		timerWheelSchedule(&delayComponentExecutionState->timer, flowState, componentIndex, delayComponentExecutionState->waitUntil);
 	} else {
 		if (millis() >= delayComponentExecutionState->waitUntil) {
 			deallocateComponentExecutionState(flowState, componentIndex);
 			propagateValueThroughSeqout(flowState, componentIndex);
 		} else {
-			if (!addToQueue(flowState, componentIndex, -1, -1, -1, true)) {
-				return;
-			}
+			timerWheelSchedule(&delayComponentExecutionState->timer, flowState, componentIndex, delayComponentExecutionState->waitUntil);
 		}
 	}
 }
-} 
-} 
-// -----------------------------------------------------------------------------
-// flow/components/end.cpp
-// -----------------------------------------------------------------------------
-namespace eez {
+bool saveDelayComponentExecutionState(CheckpointWriter &writer, FlowState *flowState, unsigned componentIndex) {
+	auto delayComponentExecutionState = (DelayComponenentExecutionState *)flowState->componenentExecutionStates[componentIndex];
+    int32_t remaining = (int32_t)(delayComponentExecutionState->waitUntil - millis());
+    uint32_t remainingMs = remaining > 0 ? (uint32_t)remaining : 0;
+    checkpointWrite(writer, &remainingMs, sizeof(remainingMs));
+    return true;
+}
+bool restoreDelayComponentExecutionState(CheckpointReader &reader, FlowState *flowState, unsigned componentIndex) {
+    uint32_t remainingMs;
+    if (!checkpointRead(reader, &remainingMs, sizeof(remainingMs))) {
+        return false;
+    }
+	auto delayComponentExecutionState = allocateComponentExecutionState<DelayComponenentExecutionState>(flowState, componentIndex);
+    delayComponentExecutionState->waitUntil = millis() + remainingMs;
+	timerWheelSchedule(&delayComponentExecutionState->timer, flowState, componentIndex, delayComponentExecutionState->waitUntil);
+    return true;
+}
+#endif
+} 
+} 
+// -----------------------------------------------------------------------------
+// flow/components/end.cpp
+// -----------------------------------------------------------------------------
+namespace eez {
 namespace flow {
 void executeEndComponent(FlowState *flowState, unsigned componentIndex) {
 	if (flowState->parentFlowState && flowState->isAction) {
@@ -4002,6 +5253,11 @@ struct LVGLUserWidgetComponent : public Component {
     int32_t widgetStartIndex;
 };
 LVGLUserWidgetExecutionState *createUserWidgetFlowState(FlowState *flowState, unsigned userWidgetWidgetComponentIndex) {
+    if (isTracingExternalCall()) {
+        recordTraceUserWidget(flowState, userWidgetWidgetComponentIndex);
+        TraceEngineScope traceEngineScope(true);
+        return createUserWidgetFlowState(flowState, userWidgetWidgetComponentIndex);
+    }
     auto component = (LVGLUserWidgetComponent *)flowState->flow->components[userWidgetWidgetComponentIndex];
     auto userWidgetFlowState = initPageFlowState(flowState->assets, component->flowIndex, flowState, userWidgetWidgetComponentIndex);
     userWidgetFlowState->lvglWidgetStartIndex = component->widgetStartIndex;
@@ -4085,7 +5341,11 @@ struct MQTTEvent {
     Value value;
     MQTTEvent *next;
 };
+#if EEZ_FLOW_COROUTINES
+struct MQTTEventActionComponenentExecutionState : public ComponentCoroutineExecutionState {
+#else
 struct MQTTEventActionComponenentExecutionState : public ComponenentExecutionState {
+#endif
 	FlowState *flowState;
     unsigned componentIndex;
     MQTTEvent *firstEvent;
@@ -4128,8 +5388,6 @@ struct MQTTConnection {
     MQTTConnection *next;
     MQTTConnection *prev;
 };
-MQTTConnection *g_firstMQTTConnection = nullptr;
-MQTTConnection *g_lastMQTTConnection = nullptr;
 static MQTTConnection *addConnection(void *handle) {
     auto connection = ObjectAllocator<MQTTConnection>::allocate(0x95d9f5d1);
     if (!connection) {
@@ -4138,21 +5396,21 @@ static MQTTConnection *addConnection(void *handle) {
     connection->handle = handle;
     connection->firstEventHandler = nullptr;
     connection->lastEventHandler = nullptr;
-    if (!g_firstMQTTConnection) {
-        g_firstMQTTConnection = connection;
-        g_lastMQTTConnection = connection;
+    if (!g_runtime->firstMQTTConnection) {
+        g_runtime->firstMQTTConnection = connection;
+        g_runtime->lastMQTTConnection = connection;
         connection->prev = nullptr;
         connection->next = nullptr;
     } else {
-        g_lastMQTTConnection->next = connection;
-        connection->prev = g_lastMQTTConnection;
+        g_runtime->lastMQTTConnection->next = connection;
+        connection->prev = g_runtime->lastMQTTConnection;
         connection->next = nullptr;
-        g_lastMQTTConnection = connection;
+        g_runtime->lastMQTTConnection = connection;
     }
     return connection;
 }
 static MQTTConnection *findConnection(void *handle) {
-    for (auto connection = g_firstMQTTConnection; connection; connection = connection->next) {
+    for (auto connection = g_runtime->firstMQTTConnection; connection; connection = connection->next) {
         if (connection->handle == handle) {
             return connection;
         }
@@ -4174,12 +5432,12 @@ static void deleteConnection(void *handle) {
     if (connection->prev) {
         connection->prev->next = connection->next;
     } else {
-        g_firstMQTTConnection = connection->next;
+        g_runtime->firstMQTTConnection = connection->next;
     }
     if (connection->next) {
         connection->next->prev = connection->prev;
     } else {
-        g_lastMQTTConnection = connection->prev;
+        g_runtime->lastMQTTConnection = connection->prev;
     }
     ObjectAllocator<MQTTConnection>::deallocate(connection);
 }
@@ -4207,7 +5465,7 @@ MQTTConnectionEventHandler *addConnectionEventHandler(void *handle, MQTTEventAct
     return eventHandler;
 }
 static void removeEventHandler(MQTTEventActionComponenentExecutionState *componentExecutionState) {
-    for (auto connection = g_firstMQTTConnection; connection; connection = connection->next) {
+    for (auto connection = g_runtime->firstMQTTConnection; connection; connection = connection->next) {
         for (auto eventHandler = connection->firstEventHandler; eventHandler; eventHandler = eventHandler->next) {
             if (eventHandler->componentExecutionState == componentExecutionState) {
                 if (eventHandler->prev) {
@@ -4274,6 +5532,11 @@ void eez_mqtt_on_event_callback(void *handle, EEZ_MQTT_Event event, void *eventD
                 componentExecutionState->addEvent(component->messageEventOutputIndex, messageValue);
             }
         }
+#if EEZ_FLOW_COROUTINES
+        if (componentExecutionState->firstEvent) {
+            signalComponentCoroutine(componentExecutionState);
+        }
+#endif
     }
 }
 void onFreeMQTTConnection(ArrayValue *mqttConnectionValue) {
@@ -4400,6 +5663,43 @@ void executeMQTTDisconnectComponent(FlowState *flowState, unsigned componentInde
     }
 	propagateValueThroughSeqout(flowState, componentIndex);
 }
+#if EEZ_FLOW_COROUTINES
+static ComponentCoroutine mqttEventComponentCoroutine(FlowState *flowState, unsigned componentIndex, void *handle) {
+    auto componentExecutionState = (MQTTEventActionComponenentExecutionState *)flowState->componenentExecutionStates[componentIndex];
+    componentExecutionState->flowState = flowState;
+    componentExecutionState->componentIndex = componentIndex;
+    addConnectionEventHandler(handle, componentExecutionState);
+    propagateValueThroughSeqout(flowState, componentIndex);
+    while (true) {
+        auto event = componentExecutionState->removeEvent();
+        if (!event) {
+            co_await waitForSignal();
+            continue;
+        }
+        propagateValue(flowState, componentIndex, event->outputIndex, event->value);
+        ObjectAllocator<MQTTEvent>::deallocate(event);
+        if (componentExecutionState->firstEvent) {
+            co_await yieldToScheduler();
+        }
+    }
+}
+void executeMQTTEventComponent(FlowState *flowState, unsigned componentIndex) {
+    if (flowState->componenentExecutionStates[componentIndex]) {
+        resumeComponentCoroutine(flowState, componentIndex);
+        return;
+    }
+    Value connectionValue;
+    if (!evalProperty(flowState, componentIndex, defs_v3::MQTT_EVENT_ACTION_COMPONENT_PROPERTY_CONNECTION, connectionValue, "Failed to evaluate Connection in MQTTEvent")) {
+        return;
+    }
+    if (!connectionValue.isArray() || connectionValue.getArray()->arrayType != defs_v3::OBJECT_TYPE_MQTT_CONNECTION) {
+        throwError(flowState, componentIndex, "Connection must be a object:MQTTConnection");
+        return;
+    }
+    void *handle = connectionValue.getArray()->values[defs_v3::OBJECT_TYPE_MQTT_CONNECTION_FIELD_ID].getVoidPointer();
+    startComponentCoroutine<MQTTEventActionComponenentExecutionState>(flowState, componentIndex, mqttEventComponentCoroutine(flowState, componentIndex, handle));
+}
+#else
 void executeMQTTEventComponent(FlowState *flowState, unsigned componentIndex) {
     Value connectionValue;
     if (!evalProperty(flowState, componentIndex, defs_v3::MQTT_EVENT_ACTION_COMPONENT_PROPERTY_CONNECTION, connectionValue, "Failed to evaluate Connection in MQTTEvent")) {
@@ -4424,11 +5724,11 @@ void executeMQTTEventComponent(FlowState *flowState, unsigned componentIndex) {
         if (event) {
             propagateValue(flowState, componentIndex, event->outputIndex, event->value);
             ObjectAllocator<MQTTEvent>::deallocate(event);
-        } else {
-            addToQueue(flowState, componentIndex, -1, -1, -1, true);
         }
+        addToQueue(flowState, componentIndex, -1, -1, -1, true);
     }
 }
+#endif
 void executeMQTTSubscribeComponent(FlowState *flowState, unsigned componentIndex) {
     Value connectionValue;
     if (!evalProperty(flowState, componentIndex, defs_v3::MQTT_SUBSCRIBE_ACTION_COMPONENT_PROPERTY_CONNECTION, connectionValue, "Failed to evaluate Connection in MQTTSubscribe")) {
@@ -4672,13 +5972,11 @@ void executeSelectLanguageComponent(FlowState *flowState, unsigned componentInde
 		return;
 	}
 	const char *language = languageValue.getString();
-    auto &languages = flowState->assets->languages;
-    for (uint32_t languageIndex = 0; languageIndex < languages.count; languageIndex++) {
-        if (strcmp(languages[languageIndex]->languageID, language) == 0) {
-            g_selectedLanguage = languageIndex;
-	        propagateValueThroughSeqout(flowState, componentIndex);
-            return;
-        }
+    auto languageIndex = findAssetsName(flowState->assets, ASSETS_NAME_TABLE_LANGUAGES, language);
+    if (languageIndex != -1) {
+        g_runtime->selectedLanguage = languageIndex;
+        propagateValueThroughSeqout(flowState, componentIndex);
+        return;
     }
     char message[256];
     snprintf(message, sizeof(message), "Unknown language %s", language);
@@ -4735,31 +6033,30 @@ void executeShowPageComponent(FlowState *flowState, unsigned componentIndex) {
 #include <stdlib.h>
 namespace eez {
 namespace flow {
-SortArrayActionComponent *g_sortArrayActionComponent;
 int elementCompare(const void *a, const void *b) {
     auto aValue = *(const Value *)a;
     auto bValue = *(const Value *)b;
-    if (g_sortArrayActionComponent->arrayType != -1) {
+    if (g_runtime->sortArrayActionComponent->arrayType != -1) {
         if (!aValue.isArray()) {
             return 0;
         }
         auto aArray = aValue.getArray();
-        if ((uint32_t)g_sortArrayActionComponent->structFieldIndex >= aArray->arraySize) {
+        if ((uint32_t)g_runtime->sortArrayActionComponent->structFieldIndex >= aArray->arraySize) {
             return 0;
         }
-        aValue = aArray->values[g_sortArrayActionComponent->structFieldIndex];
+        aValue = aArray->values[g_runtime->sortArrayActionComponent->structFieldIndex];
         if (!bValue.isArray()) {
             return 0;
         }
         auto bArray = bValue.getArray();
-        if ((uint32_t)g_sortArrayActionComponent->structFieldIndex >= bArray->arraySize) {
+        if ((uint32_t)g_runtime->sortArrayActionComponent->structFieldIndex >= bArray->arraySize) {
             return 0;
         }
-        bValue = bArray->values[g_sortArrayActionComponent->structFieldIndex];
+        bValue = bArray->values[g_runtime->sortArrayActionComponent->structFieldIndex];
     }
     int result;
     if (aValue.isString() && bValue.isString()) {
-        if (g_sortArrayActionComponent->flags & SORT_ARRAY_FLAG_IGNORE_CASE) {
+        if (g_runtime->sortArrayActionComponent->flags & SORT_ARRAY_FLAG_IGNORE_CASE) {
             result = utf8casecmp(aValue.getString(), bValue.getString());
         } else {
             result = utf8cmp(aValue.getString(), bValue.getString());
@@ -4777,13 +6074,13 @@ int elementCompare(const void *a, const void *b) {
         auto diff = aDouble - bDouble;
         result = diff < 0 ? -1 : diff > 0 ? 1 : 0;
     }
-    if (!(g_sortArrayActionComponent->flags & SORT_ARRAY_FLAG_ASCENDING)) {
+    if (!(g_runtime->sortArrayActionComponent->flags & SORT_ARRAY_FLAG_ASCENDING)) {
         result = -result;
     }
     return result;
 }
 void sortArray(SortArrayActionComponent *component, ArrayValue *array) {
-    g_sortArrayActionComponent = component;
+    g_runtime->sortArrayActionComponent = component;
     qsort(&array->values[0], array->arraySize, sizeof(Value), elementCompare);
 }
 void executeSortArrayComponent(FlowState *flowState, unsigned componentIndex) {
@@ -4919,6 +6216,57 @@ void executeWatchVariableComponent(FlowState *flowState, unsigned componentIndex
 } 
 } 
 // -----------------------------------------------------------------------------
+// flow/coroutine.cpp
+// -----------------------------------------------------------------------------
+#if EEZ_FLOW_COROUTINES
+namespace eez {
+namespace flow {
+static bool isWaitingForSignal(ComponentCoroutineExecutionState *state) {
+    return state->wait == COMPONENT_COROUTINE_WAIT_SIGNAL || state->wait == COMPONENT_COROUTINE_WAIT_READY;
+}
+ComponentCoroutineExecutionState::~ComponentCoroutineExecutionState() {
+    timerWheelCancel(&timer);
+    if (handle) {
+        if (isWaitingForSignal(this)) {
+            decRefCounterForFlowState(handle.promise().flowState);
+        }
+        handle.destroy();
+    }
+}
+void runComponentCoroutine(FlowState *flowState, unsigned componentIndex, ComponentCoroutineExecutionState *state) {
+    if (isWaitingForSignal(state)) {
+        decRefCounterForFlowState(flowState);
+    }
+    state->wait = COMPONENT_COROUTINE_WAIT_NONE;
+    state->handle.resume();
+    if (flowState->componenentExecutionStates[componentIndex] == state && state->handle.done()) {
+        deallocateComponentExecutionState(flowState, componentIndex);
+    }
+}
+void resumeComponentCoroutine(FlowState *flowState, unsigned componentIndex) {
+    auto state = (ComponentCoroutineExecutionState *)flowState->componenentExecutionStates[componentIndex];
+    if (state->wait == COMPONENT_COROUTINE_WAIT_TIMER) {
+        if (timerWheelIsScheduled(&state->timer)) {
+            return;
+        }
+    } else if (state->wait == COMPONENT_COROUTINE_WAIT_SIGNAL || state->wait == COMPONENT_COROUTINE_WAIT_NONE) {
+        return;
+    }
+    runComponentCoroutine(flowState, componentIndex, state);
+}
+void signalComponentCoroutine(ComponentCoroutineExecutionState *state) {
+    if (state->wait == COMPONENT_COROUTINE_WAIT_SIGNAL) {
+        auto &promise = state->handle.promise();
+        state->wait = COMPONENT_COROUTINE_WAIT_READY;
+        addToQueue(promise.flowState, promise.componentIndex, -1, -1, -1, false);
+    } else {
+        state->signaled = true;
+    }
+}
+} 
+} 
+#endif
+// -----------------------------------------------------------------------------
 // flow/date.cpp
 // -----------------------------------------------------------------------------
 #include <stdio.h>
@@ -4928,9 +6276,7 @@ namespace date {
 #define SECONDS_PER_MINUTE 60UL
 #define SECONDS_PER_HOUR (SECONDS_PER_MINUTE * 60)
 #define SECONDS_PER_DAY (SECONDS_PER_HOUR * 24)
-#define LEAP_YEAR(Y)                                                                               \
-    (((1970 + Y) > 0) && !((1970 + Y) % 4) && (((1970 + Y) % 100) || !((1970 + Y) % 400)))
-static const uint8_t monthDays[] = { 31, 28, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31 };
+#define MILLISECONDS_PER_DAY (SECONDS_PER_DAY * 1000ULL)
 enum Week { Last, First, Second, Third, Fourth };
 enum DayOfWeek { Sun = 1, Mon, Tue, Wed, Thu, Fri, Sat };
 enum Month { Jan = 1, Feb, Mar, Apr, May, Jun, Jul, Aug, Sep, Oct, Nov, Dec };
@@ -4948,153 +6294,169 @@ static struct {
     { { Second, Sun, Mar, 2 }, { First, Sun, Nov, 2 } }, 
     { { First, Sun, Oct, 2 }, { First, Sun, Apr, 3 } },  
 };
-Format g_localeFormat = FORMAT_DMY_24;
-int g_timeZone = 0;
-DstRule g_dstRule = DST_RULE_OFF;
+Format getLocaleFormat() {
+    return g_runtime->dateLocaleFormat;
+}
+void setLocaleFormat(Format format) {
+    g_runtime->dateLocaleFormat = format;
+}
+int getTimeZone() {
+    return g_runtime->dateTimeZone;
+}
+void setTimeZone(int timeZone) {
+    g_runtime->dateTimeZone = timeZone;
+}
+DstRule getDstRule() {
+    return g_runtime->dateDstRule;
+}
+void setDstRule(DstRule dstRule) {
+    g_runtime->dateDstRule = dstRule;
+}
 static void convertTime24to12(int &hours, bool &am);
 static bool isDst(Date time, DstRule dstRule);
 static uint8_t dayOfWeek(int y, int m, int d);
 static Date timeChangeRuleToLocal(TimeChangeRule &r, int year);
+static int32_t daysFromCivil(int year, int month, int day) {
+    year -= month <= 2;
+    int32_t era = (year >= 0 ? year : year - 399) / 400;
+    int32_t yoe = year - era * 400;
+    int32_t doy = (153 * (month > 2 ? month - 3 : month + 9) + 2) / 5 + day - 1;
+    int32_t doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;
+    return era * 146097 + doe - 719468;
+}
+static void civilFromDays(int32_t days, int &year, int &month, int &day) {
+    days += 719468;
+    int32_t era = (days >= 0 ? days : days - 146096) / 146097;
+    int32_t doe = days - era * 146097;
+    int32_t yoe = (doe - doe / 1460 + doe / 36524 - doe / 146096) / 365;
+    int32_t doy = doe - (365 * yoe + yoe / 4 - yoe / 100);
+    int32_t mp = (5 * doy + 2) / 153;
+    day = doy - (153 * mp + 2) / 5 + 1;
+    month = mp < 10 ? mp + 3 : mp - 9;
+    year = yoe + era * 400 + (month <= 2);
+}
+static const char *parseNumber(const char *str, int maxDigits, int &value, int &numDigits) {
+    value = 0;
+    numDigits = 0;
+    while (numDigits < maxDigits && *str >= '0' && *str <= '9') {
+        value = value * 10 + (*str++ - '0');
+        numDigits++;
+    }
+    return str;
+}
 Date now() {
+    if (g_runtime->traceMode != TRACE_MODE_OFF) {
+        return utcToLocal(traceDateNow(getDateNowHook));
+    }
     return utcToLocal(getDateNowHook());
 }
 void toString(Date time, char *str, uint32_t strLen) {
     int year, month, day, hours, minutes, seconds, milliseconds;
     breakDate(time, year, month, day, hours, minutes, seconds, milliseconds);
-    snprintf(str, strLen, "%04d-%02d-%02dT%02d:%02d:%02d.%06d", year, month, day, hours, minutes, seconds, milliseconds);
+    snprintf(str, strLen, "%04d-%02d-%02dT%02d:%02d:%02d.%03d", year, month, day, hours, minutes, seconds, milliseconds);
 }
 void toLocaleString(Date time, char *str, uint32_t strLen) {
     int year, month, day, hours, minutes, seconds, milliseconds;
     breakDate(time, year, month, day, hours, minutes, seconds, milliseconds);
-    if (g_localeFormat == FORMAT_DMY_24) {
+    if (g_runtime->dateLocaleFormat == FORMAT_DMY_24) {
         snprintf(str, strLen, "%02d-%02d-%02d %02d:%02d:%02d.%03d", day, month, year, hours, minutes, seconds, milliseconds);
-    } else if (g_localeFormat == FORMAT_MDY_24) {
+    } else if (g_runtime->dateLocaleFormat == FORMAT_MDY_24) {
         snprintf(str, strLen, "%02d-%02d-%02d %02d:%02d:%02d.%03d", month, day, year, hours, minutes, seconds, milliseconds);
-    } else if (g_localeFormat == FORMAT_DMY_12) {
+    } else if (g_runtime->dateLocaleFormat == FORMAT_DMY_12) {
         bool am;
         convertTime24to12(hours, am);
         snprintf(str, strLen, "%02d-%02d-%02d %02d:%02d:%02d.%03d %s", day, month, year, hours, minutes, seconds, milliseconds, am ? "AM" : "PM");
-    } else if (g_localeFormat == FORMAT_MDY_12) {
+    } else if (g_runtime->dateLocaleFormat == FORMAT_MDY_12) {
         bool am;
         convertTime24to12(hours, am);
         snprintf(str, strLen, "%02d-%02d-%02d %02d:%02d:%02d.%03d %s", month, day, year, hours, minutes, seconds, milliseconds, am ? "AM" : "PM");
     }
 }
 Date fromString(const char *str) {
-    int year = 0, month = 0, day = 0, hours = 0, minutes = 0, seconds = 0, milliseconds = 0;
-    sscanf(str, "%d-%d-%dT%d:%d:%d.%d", &year, &month, &day, &hours, &minutes, &seconds, &milliseconds);
-    return makeDate(year, month, day, hours, minutes, seconds, milliseconds);
-}
-Date makeDate(int year, int month, int day, int hours, int minutes, int seconds, int milliseconds) {
-    year -= 1970;
-    Date time = year * 365 * SECONDS_PER_DAY;
-    for (int i = 0; i < year; i++) {
-        if (LEAP_YEAR(i)) {
-            time += SECONDS_PER_DAY; 
-        }
-    }
-    for (int i = 1; i < month; i++) {
-        if ((i == 2) && LEAP_YEAR(year)) {
-            time += SECONDS_PER_DAY * 29;
-        } else {
-            time += SECONDS_PER_DAY * monthDays[i - 1]; 
+    int fields[7] = { 0, 1, 1, 0, 0, 0, 0 };
+    static const char separators[] = { '-', '-', 'T', ':', ':', '.' };
+    while (*str == ' ') {
+        str++;
+    }
+    for (int i = 0; i < 7; i++) {
+        int numDigits;
+        str = parseNumber(str, i == 0 ? 4 : (i == 6 ? 9 : 2), fields[i], numDigits);
+        if (numDigits == 0) {
+            break;
         }
-    }
-    time += (day - 1) * SECONDS_PER_DAY;
-    time += hours * SECONDS_PER_HOUR;
-    time += minutes * SECONDS_PER_MINUTE;
-    time += seconds;
-    time *= 1000;
-    time += milliseconds;
-    return time;
-}
-void breakDate(Date time, int &result_year, int &result_month, int &result_day, int &result_hours, int &result_minutes, int &result_seconds, int &result_milliseconds) {
-    uint8_t year;
-    uint8_t month, monthLength;
-    uint32_t days;
-    result_milliseconds = time % 1000;
-    time /= 1000; 
-    result_seconds = time % 60;
-    time /= 60; 
-    result_minutes = time % 60;
-    time /= 60; 
-    result_hours = time % 24;
-    time /= 24; 
-    year = 0;
-    days = 0;
-    while ((unsigned)(days += (LEAP_YEAR(year) ? 366 : 365)) <= time) {
-        year++;
-    }
-    result_year = year + 1970; 
-    days -= LEAP_YEAR(year) ? 366 : 365;
-    time -= days; 
-    days = 0;
-    month = 0;
-    monthLength = 0;
-    for (month = 0; month < 12; ++month) {
-        if (month == 1) { 
-            if (LEAP_YEAR(year)) {
-                monthLength = 29;
-            } else {
-                monthLength = 28;
+        if (i == 6) {
+            for (; numDigits < 3; numDigits++) {
+                fields[i] *= 10;
+            }
+            for (; numDigits > 3; numDigits--) {
+                fields[i] /= 10;
             }
-        } else {
-            monthLength = monthDays[month];
         }
-        if (time >= monthLength) {
-            time -= monthLength;
-        } else {
+        if (i == 6 || (*str != separators[i] && !(i == 2 && *str == ' '))) {
             break;
         }
+        str++;
     }
-    result_month = month + 1; 
-    result_day = time + 1;    
+    return makeDate(fields[0], fields[1], fields[2], fields[3], fields[4], fields[5], fields[6]);
+}
+Date makeDate(int year, int month, int day, int hours, int minutes, int seconds, int milliseconds) {
+    month -= 1;
+    year += month >= 0 ? month / 12 : (month - 11) / 12;
+    month = month - (month >= 0 ? month / 12 : (month - 11) / 12) * 12 + 1;
+    int64_t time = (int64_t)daysFromCivil(year, month, 1) + day - 1;
+    time = time * 24 + hours;
+    time = time * 60 + minutes;
+    time = time * 60 + seconds;
+    time = time * 1000 + milliseconds;
+    return (Date)time;
+}
+void breakDate(Date time, int &result_year, int &result_month, int &result_day, int &result_hours, int &result_minutes, int &result_seconds, int &result_milliseconds) {
+    uint32_t msOfDay = (uint32_t)(time % MILLISECONDS_PER_DAY);
+    civilFromDays((int32_t)(time / MILLISECONDS_PER_DAY), result_year, result_month, result_day);
+    result_milliseconds = msOfDay % 1000;
+    msOfDay /= 1000;
+    result_seconds = msOfDay % 60;
+    msOfDay /= 60;
+    result_minutes = msOfDay % 60;
+    result_hours = msOfDay / 60;
 }
 int getYear(Date time) {
-    int year, month, day, hours, minutes, seconds, milliseconds;
-    breakDate(time, year, month, day, hours, minutes, seconds, milliseconds);
+    int year, month, day;
+    civilFromDays((int32_t)(time / MILLISECONDS_PER_DAY), year, month, day);
     return year;
 }
 int getMonth(Date time) {
-    int year, month, day, hours, minutes, seconds, milliseconds;
-    breakDate(time, year, month, day, hours, minutes, seconds, milliseconds);
+    int year, month, day;
+    civilFromDays((int32_t)(time / MILLISECONDS_PER_DAY), year, month, day);
     return month;
 }
 int getDay(Date time) {
-    int year, month, day, hours, minutes, seconds, milliseconds;
-    breakDate(time, year, month, day, hours, minutes, seconds, milliseconds);
+    int year, month, day;
+    civilFromDays((int32_t)(time / MILLISECONDS_PER_DAY), year, month, day);
     return day;
 }
 int getHours(Date time) {
-    int year, month, day, hours, minutes, seconds, milliseconds;
-    breakDate(time, year, month, day, hours, minutes, seconds, milliseconds);
-    return hours;
+    return (int)(time % MILLISECONDS_PER_DAY / (SECONDS_PER_HOUR * 1000));
 }
 int getMinutes(Date time) {
-    int year, month, day, hours, minutes, seconds, milliseconds;
-    breakDate(time, year, month, day, hours, minutes, seconds, milliseconds);
-    return minutes;
+    return (int)(time / (SECONDS_PER_MINUTE * 1000) % 60);
 }
 int getSeconds(Date time) {
-    int year, month, day, hours, minutes, seconds, milliseconds;
-    breakDate(time, year, month, day, hours, minutes, seconds, milliseconds);
-    return seconds;
+    return (int)(time / 1000 % 60);
 }
 int getMilliseconds(Date time) {
-    int year, month, day, hours, minutes, seconds, milliseconds;
-    breakDate(time, year, month, day, hours, minutes, seconds, milliseconds);
-    return milliseconds;
+    return (int)(time % 1000);
 }
 Date utcToLocal(Date utc) {
-    Date local = utc + ((g_timeZone / 100) * 60 + g_timeZone % 100) * 60L * 1000L;
-    if (isDst(local, g_dstRule)) {
+    Date local = utc + ((g_runtime->dateTimeZone / 100) * 60 + g_runtime->dateTimeZone % 100) * 60L * 1000L;
+    if (isDst(local, g_runtime->dateDstRule)) {
         local += SECONDS_PER_HOUR * 1000L;
     }
     return local;
 }
 Date localToUtc(Date local) {
-    Date utc = local - ((g_timeZone / 100) * 60 + g_timeZone % 100) * 60L * 1000L;
-    if (isDst(local, g_dstRule)) {
+    Date utc = local - ((g_runtime->dateTimeZone / 100) * 60 + g_runtime->dateTimeZone % 100) * 60L * 1000L;
+    if (isDst(local, g_runtime->dateDstRule)) {
         utc -= SECONDS_PER_HOUR * 1000L;
     }
     return utc;
@@ -5142,9 +6504,9 @@ static Date timeChangeRuleToLocal(TimeChangeRule &r, int year) {
     }
     Date time = makeDate(year, month, 1, r.hours, 0, 0, 0);
     uint8_t dow = dayOfWeek(year, month, 1);
-    time += (7 * (week - 1) + (r.dow - dow + 7) % 7) * SECONDS_PER_DAY;
+    time += (7 * (week - 1) + (r.dow - dow + 7) % 7) * MILLISECONDS_PER_DAY;
     if (r.week == 0) {
-        time -= 7 * SECONDS_PER_DAY; 
+        time -= 7 * MILLISECONDS_PER_DAY; 
     }
     return time;
 }
@@ -5176,7 +6538,8 @@ enum MessagesToDebugger {
     MESSAGE_TO_DEBUGGER_LOG, 
 	MESSAGE_TO_DEBUGGER_PAGE_CHANGED, 
     MESSAGE_TO_DEBUGGER_COMPONENT_EXECUTION_STATE_CHANGED, 
-    MESSAGE_TO_DEBUGGER_COMPONENT_ASYNC_STATE_CHANGED 
+    MESSAGE_TO_DEBUGGER_COMPONENT_ASYNC_STATE_CHANGED, 
+    MESSAGE_TO_DEBUGGER_QUEUE_STATS 
 };
 enum MessagesFromDebugger {
     MESSAGE_FROM_DEBUGGER_RESUME, 
@@ -5196,56 +6559,43 @@ enum LogItemType {
     LOG_ITEM_TYPE_INFO,
     LOG_ITEM_TYPE_DEBUG
 };
-enum DebuggerState {
-    DEBUGGER_STATE_RESUMED,
-    DEBUGGER_STATE_PAUSED,
-    DEBUGGER_STATE_SINGLE_STEP,
-    DEBUGGER_STATE_STOPPED,
-};
-bool g_debuggerIsConnected;
-static uint32_t g_messageSubsciptionFilter = 0xFFFFFFFF;
-static DebuggerState g_debuggerState;
-static bool g_skipNextBreakpoint;
-static char g_inputFromDebugger[64];
-static unsigned g_inputFromDebuggerPosition;
-int g_debuggerMode = DEBUGGER_MODE_RUN;
 void setDebuggerMessageSubsciptionFilter(uint32_t filter) {
-    g_messageSubsciptionFilter = filter;
+    g_runtime->messageSubsciptionFilter = filter;
 }
 bool isSubscribedTo(MessagesToDebugger messageType) {
-    if (g_debuggerIsConnected && (g_messageSubsciptionFilter & (1 << messageType)) != 0) {
+    if (g_runtime->debuggerIsConnected && (g_runtime->messageSubsciptionFilter & (1 << messageType)) != 0) {
         startToDebuggerMessageHook();
         return true;
     }
     return false;
 }
 static void setDebuggerState(DebuggerState newState) {
-	if (newState != g_debuggerState) {
-		g_debuggerState = newState;
+	if (newState != g_runtime->debuggerState) {
+		g_runtime->debuggerState = newState;
 		if (isSubscribedTo(MESSAGE_TO_DEBUGGER_STATE_CHANGED)) {
 			char buffer[256];
 			snprintf(buffer, sizeof(buffer), "%d\t%d\n",
 				MESSAGE_TO_DEBUGGER_STATE_CHANGED,
-				g_debuggerState
+				g_runtime->debuggerState
 			);
 			writeDebuggerBufferHook(buffer, strlen(buffer));
 		}
 	}
 }
 void onDebuggerClientConnected() {
-    g_debuggerIsConnected = true;
-	g_skipNextBreakpoint = false;
-	g_inputFromDebuggerPosition = 0;
+    g_runtime->debuggerIsConnected = true;
+	g_runtime->skipNextBreakpoint = false;
+	g_runtime->inputFromDebuggerPosition = 0;
     setDebuggerState(DEBUGGER_STATE_PAUSED);
 }
 void onDebuggerClientDisconnected() {
-    g_debuggerIsConnected = false;
+    g_runtime->debuggerIsConnected = false;
     setDebuggerState(DEBUGGER_STATE_RESUMED);
 }
 void processDebuggerInput(char *buffer, uint32_t length) {
 	for (uint32_t i = 0; i < length; i++) {
 		if (buffer[i] == '\n') {
-			int messageFromDebugger = g_inputFromDebugger[0] - '0';
+			int messageFromDebugger = g_runtime->inputFromDebugger[0] - '0';
 			if (messageFromDebugger == MESSAGE_FROM_DEBUGGER_RESUME) {
 				setDebuggerState(DEBUGGER_STATE_RESUMED);
 			} else if (messageFromDebugger == MESSAGE_FROM_DEBUGGER_PAUSE) {
@@ -5257,9 +6607,9 @@ void processDebuggerInput(char *buffer, uint32_t length) {
 				messageFromDebugger <= MESSAGE_FROM_DEBUGGER_DISABLE_BREAKPOINT
 			) {
 				char *p;
-				auto flowIndex = (uint32_t)strtol(g_inputFromDebugger + 2, &p, 10);
+				auto flowIndex = (uint32_t)strtol(g_runtime->inputFromDebugger + 2, &p, 10);
 				auto componentIndex = (uint32_t)strtol(p + 1, nullptr, 10);
-				auto assets = g_firstFlowState->assets;
+				auto assets = g_runtime->firstFlowState->assets;
 				auto flowDefinition = static_cast<FlowDefinition *>(assets->flowDefinition);
 				if (flowIndex >= 0 && flowIndex < flowDefinition->flows.count) {
 					auto flow = flowDefinition->flows[flowIndex];
@@ -5274,42 +6624,42 @@ void processDebuggerInput(char *buffer, uint32_t length) {
 					ErrorTrace("Invalid breakpoint flow index\n");
 				}
 			} else if (messageFromDebugger == MESSAGE_FROM_DEBUGGER_MODE) {
-                g_debuggerMode = strtol(g_inputFromDebugger + 2, nullptr, 10);
+                g_runtime->debuggerMode = strtol(g_runtime->inputFromDebugger + 2, nullptr, 10);
 #if EEZ_OPTION_GUI
                 gui::refreshScreen();
 #endif
             }
-			g_inputFromDebuggerPosition = 0;
+			g_runtime->inputFromDebuggerPosition = 0;
 		} else {
-			if (g_inputFromDebuggerPosition < sizeof(g_inputFromDebugger)) {
-				g_inputFromDebugger[g_inputFromDebuggerPosition++] = buffer[i];
-			} else if (g_inputFromDebuggerPosition == sizeof(g_inputFromDebugger)) {
+			if (g_runtime->inputFromDebuggerPosition < sizeof(g_runtime->inputFromDebugger)) {
+				g_runtime->inputFromDebugger[g_runtime->inputFromDebuggerPosition++] = buffer[i];
+			} else if (g_runtime->inputFromDebuggerPosition == sizeof(g_runtime->inputFromDebugger)) {
 				ErrorTrace("Input from debugger buffer overflow\n");
 			}
 		}
 	}
 }
 bool canExecuteStep(FlowState *&flowState, unsigned &componentIndex) {
-    if (!g_debuggerIsConnected) {
+    if (!g_runtime->debuggerIsConnected) {
         return true;
     }
     if (!isSubscribedTo(MESSAGE_TO_DEBUGGER_ADD_TO_QUEUE)) {
         return true;
     }
-    if (g_debuggerState == DEBUGGER_STATE_PAUSED) {
+    if (g_runtime->debuggerState == DEBUGGER_STATE_PAUSED) {
         return false;
     }
-    if (g_debuggerState == DEBUGGER_STATE_SINGLE_STEP) {
-        g_skipNextBreakpoint = false;
+    if (g_runtime->debuggerState == DEBUGGER_STATE_SINGLE_STEP) {
+        g_runtime->skipNextBreakpoint = false;
 	    setDebuggerState(DEBUGGER_STATE_PAUSED);
         return true;
     }
-    if (g_skipNextBreakpoint) {
-        g_skipNextBreakpoint = false;
+    if (g_runtime->skipNextBreakpoint) {
+        g_runtime->skipNextBreakpoint = false;
     } else {
         auto component = flowState->flow->components[componentIndex];
         if (component->breakpoint) {
-            g_skipNextBreakpoint = true;
+            g_runtime->skipNextBreakpoint = true;
 			setDebuggerState(DEBUGGER_STATE_PAUSED);
             return false;
         }
@@ -5478,8 +6828,14 @@ void writeValue(const Value &value) {
 		snprintf(tempStr, sizeof(tempStr) - 1, ">%d", (int)(value.int32Value));
 		break;
 	case VALUE_TYPE_JSON:
+#if defined(EEZ_DASHBOARD_API)
 		snprintf(tempStr, sizeof(tempStr) - 1, "#%d", (int)(value.int32Value));
 		break;
+#else
+		jsonValueToText(value, tempStr, sizeof(tempStr) - 1);
+		writeString(tempStr);
+		return;
+#endif
 	case VALUE_TYPE_DATE:
         tempStr[0] = '!';
 		writeHex(tempStr + 1, (uint8_t *)&value.doubleValue, sizeof(double));
@@ -5511,12 +6867,42 @@ void writeValue(const Value &value) {
 	stringAppendString(tempStr, sizeof(tempStr), "\n");
 	writeDebuggerBufferHook(tempStr, strlen(tempStr));
 }
+bool isDebuggerTrackingQueue() {
+    return g_runtime->debuggerIsConnected && (g_runtime->messageSubsciptionFilter & (1 << MESSAGE_TO_DEBUGGER_ADD_TO_QUEUE)) != 0;
+}
+void onQueueStats() {
+    QueueStats stats;
+    getQueueStats(stats);
+    if (
+        stats.size == g_runtime->lastQueueStats.size &&
+        stats.capacity == g_runtime->lastQueueStats.capacity &&
+        stats.highWaterMark == g_runtime->lastQueueStats.highWaterMark &&
+        stats.averageDepth == g_runtime->lastQueueStats.averageDepth &&
+        stats.overflowsAvoided == g_runtime->lastQueueStats.overflowsAvoided
+    ) {
+        return;
+    }
+    g_runtime->lastQueueStats = stats;
+    if (isSubscribedTo(MESSAGE_TO_DEBUGGER_QUEUE_STATS)) {
+        char buffer[256];
+		snprintf(buffer, sizeof(buffer), "%d\t%u\t%u\t%u\t%g\t%u\n",
+			MESSAGE_TO_DEBUGGER_QUEUE_STATS,
+            (unsigned int)stats.size,
+            (unsigned int)stats.capacity,
+            (unsigned int)stats.highWaterMark,
+            stats.averageDepth,
+            (unsigned int)stats.overflowsAvoided
+		);
+        writeDebuggerBufferHook(buffer, strlen(buffer));
+    }
+}
 void onStarted(Assets *assets) {
+    memset(&g_runtime->lastQueueStats, 0, sizeof(g_runtime->lastQueueStats));
     if (isSubscribedTo(MESSAGE_TO_DEBUGGER_GLOBAL_VARIABLE_INIT)) {
 		auto flowDefinition = static_cast<FlowDefinition *>(assets->flowDefinition);
-        if (g_globalVariables) {
-            for (uint32_t i = 0; i < g_globalVariables->count; i++) {
-                auto pValue = g_globalVariables->values + i;
+        if (g_runtime->globalVariables) {
+            for (uint32_t i = 0; i < g_runtime->globalVariables->count; i++) {
+                auto pValue = g_runtime->globalVariables->values + i;
                 char buffer[256];
                 snprintf(buffer, sizeof(buffer), "%d\t%d\t%p\t",
                     MESSAGE_TO_DEBUGGER_GLOBAL_VARIABLE_INIT,
@@ -5781,12 +7167,12 @@ void onPageChanged(int previousPageId, int activePageId, bool activePageIsFromSt
     }
     if (!previousPageIsStillOnStack) {
         if (previousPageId > 0 && previousPageId < FIRST_INTERNAL_PAGE_ID) {
-            auto flowState = getPageFlowState(g_mainAssets, previousPageId - 1, WidgetCursor());
+            auto flowState = getPageFlowState(g_runtime->mainAssets, previousPageId - 1, WidgetCursor());
             if (flowState) {
                 onEvent(flowState, FLOW_EVENT_CLOSE_PAGE, Value());
             }
         } else if (previousPageId < 0) {
-            auto flowState = getPageFlowState(g_externalAssets, -previousPageId - 1, WidgetCursor());
+            auto flowState = getPageFlowState(g_runtime->externalAssets, -previousPageId - 1, WidgetCursor());
             if (flowState) {
                 onEvent(flowState, FLOW_EVENT_CLOSE_PAGE, Value());
             }
@@ -5794,12 +7180,12 @@ void onPageChanged(int previousPageId, int activePageId, bool activePageIsFromSt
     }
     if (!activePageIsFromStack) {
         if (activePageId > 0 && activePageId < FIRST_INTERNAL_PAGE_ID) {
-            auto flowState = getPageFlowState(g_mainAssets, activePageId - 1, WidgetCursor());
+            auto flowState = getPageFlowState(g_runtime->mainAssets, activePageId - 1, WidgetCursor());
             if (flowState) {
                 onEvent(flowState, FLOW_EVENT_OPEN_PAGE, Value());
             }
         } else if (activePageId < 0) {
-            auto flowState = getPageFlowState(g_externalAssets, -activePageId - 1, WidgetCursor());
+            auto flowState = getPageFlowState(g_runtime->externalAssets, -activePageId - 1, WidgetCursor());
             if (flowState) {
                 onEvent(flowState, FLOW_EVENT_OPEN_PAGE, Value());
             }
@@ -5824,7 +7210,7 @@ void onPageChanged(int previousPageId, int activePageId, bool activePageIsFromSt
     }
     if (!previousPageIsStillOnStack) {
         if (previousPageId > 0) {
-            auto flowState = getPageFlowState(g_mainAssets, previousPageId - 1);
+            auto flowState = getPageFlowState(g_runtime->mainAssets, previousPageId - 1);
             if (flowState) {
                 onEvent(flowState, FLOW_EVENT_CLOSE_PAGE, Value());
             }
@@ -5832,7 +7218,7 @@ void onPageChanged(int previousPageId, int activePageId, bool activePageIsFromSt
     }
     if (!activePageIsFromStack) {
         if (activePageId > 0) {
-            auto flowState = getPageFlowState(g_mainAssets, activePageId - 1);
+            auto flowState = getPageFlowState(g_runtime->mainAssets, activePageId - 1);
             if (flowState) {
                 onEvent(flowState, FLOW_EVENT_OPEN_PAGE, Value());
             }
@@ -5859,7 +7245,6 @@ using namespace eez::gui;
 #endif
 namespace eez {
 namespace flow {
-EvalStack g_stack;
 static void evalExpression(FlowState *flowState, const uint8_t *instructions, int *numInstructionBytes, const char *errorMessage) {
 	auto flowDefinition = flowState->flowDefinition;
 	auto flow = flowState->flow;
@@ -5869,28 +7254,28 @@ static void evalExpression(FlowState *flowState, const uint8_t *instructions, in
 		auto instructionType = instruction & EXPR_EVAL_INSTRUCTION_TYPE_MASK;
 		auto instructionArg = instruction & EXPR_EVAL_INSTRUCTION_PARAM_MASK;
 		if (instructionType == EXPR_EVAL_INSTRUCTION_TYPE_PUSH_CONSTANT) {
-			g_stack.push(*flowDefinition->constants[instructionArg]);
+			g_runtime->stack.push(*flowDefinition->constants[instructionArg]);
 		} else if (instructionType == EXPR_EVAL_INSTRUCTION_TYPE_PUSH_INPUT) {
-			g_stack.push(flowState->values[instructionArg]);
+			g_runtime->stack.push(flowState->values[instructionArg]);
 		} else if (instructionType == EXPR_EVAL_INSTRUCTION_TYPE_PUSH_LOCAL_VAR) {
-			g_stack.push(&flowState->values[flow->componentInputs.count + instructionArg]);
+			g_runtime->stack.push(&flowState->values[flow->componentInputs.count + instructionArg]);
 		} else if (instructionType == EXPR_EVAL_INSTRUCTION_TYPE_PUSH_GLOBAL_VAR) {
 			if ((uint32_t)instructionArg < flowDefinition->globalVariables.count) {
-                if (g_globalVariables) {
-				    g_stack.push(g_globalVariables->values + instructionArg);
+                if (g_runtime->globalVariables) {
+				    g_runtime->stack.push(g_runtime->globalVariables->values + instructionArg);
                 } else {
-                    g_stack.push(flowDefinition->globalVariables[instructionArg]);
+                    g_runtime->stack.push(flowDefinition->globalVariables[instructionArg]);
                 }
 			} else {
-				g_stack.push(Value((int)(instructionArg - flowDefinition->globalVariables.count + 1), VALUE_TYPE_NATIVE_VARIABLE));
+				g_runtime->stack.push(Value((int)(instructionArg - flowDefinition->globalVariables.count + 1), VALUE_TYPE_NATIVE_VARIABLE));
 			}
 		} else if (instructionType == EXPR_EVAL_INSTRUCTION_TYPE_PUSH_OUTPUT) {
-			g_stack.push(Value((uint16_t)instructionArg, VALUE_TYPE_FLOW_OUTPUT));
+			g_runtime->stack.push(Value((uint16_t)instructionArg, VALUE_TYPE_FLOW_OUTPUT));
 		} else if (instructionType == EXPR_EVAL_INSTRUCTION_ARRAY_ELEMENT) {
-			auto elementIndexValue = g_stack.pop().getValue();
-			auto arrayValue = g_stack.pop().getValue();
+			auto elementIndexValue = g_runtime->stack.pop().getValue();
+			auto arrayValue = g_runtime->stack.pop().getValue();
             if (arrayValue.getType() == VALUE_TYPE_UNDEFINED || arrayValue.getType() == VALUE_TYPE_NULL) {
-                g_stack.push(Value(0, VALUE_TYPE_UNDEFINED));
+                g_runtime->stack.push(Value(0, VALUE_TYPE_UNDEFINED));
             } else {
                 if (arrayValue.isArray()) {
                     auto array = arrayValue.getArray();
@@ -5898,14 +7283,14 @@ static void evalExpression(FlowState *flowState, const uint8_t *instructions, in
                     auto elementIndex = elementIndexValue.toInt32(&err);
                     if (!err) {
                         if (elementIndex >= 0 && elementIndex < (int)array->arraySize) {
-                            g_stack.push(Value::makeArrayElementRef(arrayValue, elementIndex, 0x132e0e2f));
+                            g_runtime->stack.push(Value::makeArrayElementRef(arrayValue, elementIndex, 0x132e0e2f));
                         } else {
-                            g_stack.push(Value::makeError());
-                            g_stack.setErrorMessage("Array element index out of bounds\n");
+                            g_runtime->stack.push(Value::makeError());
+                            g_runtime->stack.setErrorMessage("Array element index out of bounds\n");
                         }
                     } else {
-                        g_stack.push(Value::makeError());
-                        g_stack.setErrorMessage("Integer value expected for array element index\n");
+                        g_runtime->stack.push(Value::makeError());
+                        g_runtime->stack.setErrorMessage("Integer value expected for array element index\n");
                     }
                 } else if (arrayValue.isBlob()) {
                     auto blobRef = arrayValue.getBlob();
@@ -5913,27 +7298,27 @@ static void evalExpression(FlowState *flowState, const uint8_t *instructions, in
                     auto elementIndex = elementIndexValue.toInt32(&err);
                     if (!err) {
                         if (elementIndex >= 0 && elementIndex < (int)blobRef->len) {
-                            g_stack.push(Value::makeArrayElementRef(arrayValue, elementIndex, 0x132e0e2f));
+                            g_runtime->stack.push(Value::makeArrayElementRef(arrayValue, elementIndex, 0x132e0e2f));
                         } else {
-                            g_stack.push(Value::makeError());
-                            g_stack.setErrorMessage("Blob element index out of bounds\n");
+                            g_runtime->stack.push(Value::makeError());
+                            g_runtime->stack.setErrorMessage("Blob element index out of bounds\n");
                         }
                     } else {
-                        g_stack.push(Value::makeError());
-                        g_stack.setErrorMessage("Integer value expected for blob element index\n");
+                        g_runtime->stack.push(Value::makeError());
+                        g_runtime->stack.setErrorMessage("Integer value expected for blob element index\n");
                     }
                 } else {
-                    g_stack.push(Value::makeError());
-                    g_stack.setErrorMessage("Array value expected\n");
+                    g_runtime->stack.push(Value::makeError());
+                    g_runtime->stack.setErrorMessage("Array value expected\n");
                 }
             }
 		} else if (instructionType == EXPR_EVAL_INSTRUCTION_TYPE_OPERATION) {
-			g_evalOperations[instructionArg](g_stack);
+			g_evalOperations[instructionArg](g_runtime->stack);
 		} else {
             if (instruction == EXPR_EVAL_INSTRUCTION_TYPE_END_WITH_DST_VALUE_TYPE) {
     			i += 2;
-                if (g_stack.sp == 1) {
-                    auto finalResult = g_stack.pop();
+                if (g_runtime->stack.sp == 1) {
+                    auto finalResult = g_runtime->stack.pop();
                     #define VALUE_TYPE (instructions[i] + (instructions[i + 1] << 8) + (instructions[i + 2] << 16) + (instructions[i + 3] << 24))
                     if (finalResult.getType() == VALUE_TYPE_VALUE_PTR) {
                         finalResult.dstValueType = VALUE_TYPE;
@@ -5941,7 +7326,7 @@ static void evalExpression(FlowState *flowState, const uint8_t *instructions, in
                         auto arrayElementValue = (ArrayElementValue *)finalResult.refValue;
                         arrayElementValue->dstValueType = VALUE_TYPE;
                     }
-                    g_stack.push(finalResult);
+                    g_runtime->stack.push(finalResult);
                 }
                 i += 4;
                 break;
@@ -5961,24 +7346,24 @@ bool evalExpression(FlowState *flowState, int componentIndex, const uint8_t *ins
 #else
 bool evalExpression(FlowState *flowState, int componentIndex, const uint8_t *instructions, Value &result, const char *errorMessage, int *numInstructionBytes, const int32_t *iterators) {
 #endif
-    size_t savedSp = g_stack.sp;
-    FlowState *savedFlowState = g_stack.flowState;
-	int savedComponentIndex = g_stack.componentIndex;
-	const int32_t *savedIterators = g_stack.iterators;
-    const char *savedErrorMessage = g_stack.errorMessage;
-	g_stack.flowState = flowState;
-	g_stack.componentIndex = componentIndex;
-	g_stack.iterators = iterators;
-    g_stack.errorMessage = nullptr;
+    size_t savedSp = g_runtime->stack.sp;
+    FlowState *savedFlowState = g_runtime->stack.flowState;
+	int savedComponentIndex = g_runtime->stack.componentIndex;
+	const int32_t *savedIterators = g_runtime->stack.iterators;
+    const char *savedErrorMessage = g_runtime->stack.errorMessage;
+	g_runtime->stack.flowState = flowState;
+	g_runtime->stack.componentIndex = componentIndex;
+	g_runtime->stack.iterators = iterators;
+    g_runtime->stack.errorMessage = nullptr;
 	evalExpression(flowState, instructions, numInstructionBytes, errorMessage);
-	g_stack.flowState = savedFlowState;
-	g_stack.componentIndex = savedComponentIndex;
-	g_stack.iterators = savedIterators;
-    g_stack.errorMessage = savedErrorMessage;
-    if (g_stack.sp == savedSp + 1) {
+	g_runtime->stack.flowState = savedFlowState;
+	g_runtime->stack.componentIndex = savedComponentIndex;
+	g_runtime->stack.iterators = savedIterators;
+    g_runtime->stack.errorMessage = savedErrorMessage;
+    if (g_runtime->stack.sp == savedSp + 1) {
 #if EEZ_OPTION_GUI
         if (operation == DATA_OPERATION_GET_TEXT_REFRESH_RATE) {
-            result = g_stack.pop();
+            result = g_runtime->stack.pop();
             if (!result.isError()) {
                 if (result.getType() == VALUE_TYPE_NATIVE_VARIABLE) {
                     auto nativeVariableId = result.getInt();
@@ -5989,7 +7374,7 @@ bool evalExpression(FlowState *flowState, int componentIndex, const uint8_t *ins
                 return true;
             }
         } else if (operation == DATA_OPERATION_GET_TEXT_CURSOR_POSITION) {
-            result = g_stack.pop();
+            result = g_runtime->stack.pop();
             if (!result.isError()) {
                 if (result.getType() == VALUE_TYPE_NATIVE_VARIABLE) {
                     auto nativeVariableId = result.getInt();
@@ -6001,7 +7386,7 @@ bool evalExpression(FlowState *flowState, int componentIndex, const uint8_t *ins
             }
         } else {
 #endif
-            result = g_stack.pop().getValue();
+            result = g_runtime->stack.pop().getValue();
             if (!result.isError()) {
                 return true;
             }
@@ -6009,25 +7394,25 @@ bool evalExpression(FlowState *flowState, int componentIndex, const uint8_t *ins
         }
 #endif
     }
-    throwError(flowState, componentIndex, errorMessage, g_stack.errorMessage ? g_stack.errorMessage : nullptr);
+    throwError(flowState, componentIndex, errorMessage, g_runtime->stack.errorMessage ? g_runtime->stack.errorMessage : nullptr);
 	return false;
 }
 bool evalAssignableExpression(FlowState *flowState, int componentIndex, const uint8_t *instructions, Value &result, const char *errorMessage, int *numInstructionBytes, const int32_t *iterators) {
-    FlowState *savedFlowState = g_stack.flowState;
-	int savedComponentIndex = g_stack.componentIndex;
-	const int32_t *savedIterators = g_stack.iterators;
-    const char *savedErrorMessage = g_stack.errorMessage;
-	g_stack.flowState = flowState;
-	g_stack.componentIndex = componentIndex;
-	g_stack.iterators = iterators;
-    g_stack.errorMessage = nullptr;
+    FlowState *savedFlowState = g_runtime->stack.flowState;
+	int savedComponentIndex = g_runtime->stack.componentIndex;
+	const int32_t *savedIterators = g_runtime->stack.iterators;
+    const char *savedErrorMessage = g_runtime->stack.errorMessage;
+	g_runtime->stack.flowState = flowState;
+	g_runtime->stack.componentIndex = componentIndex;
+	g_runtime->stack.iterators = iterators;
+    g_runtime->stack.errorMessage = nullptr;
 	evalExpression(flowState, instructions, numInstructionBytes, errorMessage);
-	g_stack.flowState = savedFlowState;
-	g_stack.componentIndex = savedComponentIndex;
-	g_stack.iterators = savedIterators;
-    g_stack.errorMessage = savedErrorMessage;
-    if (g_stack.sp == 1) {
-        auto finalResult = g_stack.pop();
+	g_runtime->stack.flowState = savedFlowState;
+	g_runtime->stack.componentIndex = savedComponentIndex;
+	g_runtime->stack.iterators = savedIterators;
+    g_runtime->stack.errorMessage = savedErrorMessage;
+    if (g_runtime->stack.sp == 1) {
+        auto finalResult = g_runtime->stack.pop();
         if (
             finalResult.getType() == VALUE_TYPE_VALUE_PTR ||
             finalResult.getType() == VALUE_TYPE_NATIVE_VARIABLE ||
@@ -6039,7 +7424,7 @@ bool evalAssignableExpression(FlowState *flowState, int componentIndex, const ui
             return true;
         }
     }
-    throwError(flowState, componentIndex, errorMessage, g_stack.errorMessage ? g_stack.errorMessage : nullptr);
+    throwError(flowState, componentIndex, errorMessage, g_runtime->stack.errorMessage ? g_runtime->stack.errorMessage : nullptr);
 	return false;
 }
 #if EEZ_OPTION_GUI
@@ -6091,21 +7476,21 @@ int16_t getNativeVariableId(const WidgetCursor &widgetCursor) {
 		if (widgetDataItem && widgetDataItem->componentIndex != -1 && widgetDataItem->propertyValueIndex != -1) {
 			auto component = flow->components[widgetDataItem->componentIndex];
 			auto property = component->properties[widgetDataItem->propertyValueIndex];
-            FlowState *savedFlowState = g_stack.flowState;
-            int savedComponentIndex = g_stack.componentIndex;
-            const int32_t *savedIterators = g_stack.iterators;
-            const char *savedErrorMessage = g_stack.errorMessage;
-			g_stack.flowState = flowState;
-			g_stack.componentIndex = widgetDataItem->componentIndex;
-			g_stack.iterators = widgetCursor.iterators;
-            g_stack.errorMessage = nullptr;
+            FlowState *savedFlowState = g_runtime->stack.flowState;
+            int savedComponentIndex = g_runtime->stack.componentIndex;
+            const int32_t *savedIterators = g_runtime->stack.iterators;
+            const char *savedErrorMessage = g_runtime->stack.errorMessage;
+			g_runtime->stack.flowState = flowState;
+			g_runtime->stack.componentIndex = widgetDataItem->componentIndex;
+			g_runtime->stack.iterators = widgetCursor.iterators;
+            g_runtime->stack.errorMessage = nullptr;
 			evalExpression(flowState, property->evalInstructions, nullptr, nullptr);
-            g_stack.flowState = savedFlowState;
-            g_stack.componentIndex = savedComponentIndex;
-            g_stack.iterators = savedIterators;
-            g_stack.errorMessage = savedErrorMessage;
-            if (g_stack.sp == 1) {
-                auto finalResult = g_stack.pop();
+            g_runtime->stack.flowState = savedFlowState;
+            g_runtime->stack.componentIndex = savedComponentIndex;
+            g_runtime->stack.iterators = savedIterators;
+            g_runtime->stack.errorMessage = savedErrorMessage;
+            if (g_runtime->stack.sp == 1) {
+                auto finalResult = g_runtime->stack.pop();
                 if (finalResult.getType() == VALUE_TYPE_NATIVE_VARIABLE) {
                     return finalResult.getInt();
                 }
@@ -6131,38 +7516,119 @@ namespace flow {
 #if defined(__EMSCRIPTEN__)
 uint32_t g_wasmModuleId = 0;
 #endif
-static const uint32_t FLOW_TICK_MAX_DURATION_MS = 5;
-int g_selectedLanguage = 0;
-FlowState *g_firstFlowState;
-FlowState *g_lastFlowState;
-static bool g_isStopping = false;
-static bool g_isStopped = true;
+static const unsigned FLOW_TICK_MAX_CHECK_INTERVAL = 16;
+const uint32_t TICK_OVERRUN_BUCKET_LIMITS_US[TICK_OVERRUN_NUM_BUCKETS - 1] = { 100, 250, 500, 1000, 2500, 5000, 10000 };
 static void doStop();
+static void updateComponentCost(uint32_t elapsedUs, unsigned numExecuted) {
+    uint32_t costUsQ4 = (elapsedUs << 4) / numExecuted;
+    if (g_runtime->componentCostUsQ4 == 0) {
+        g_runtime->componentCostUsQ4 = costUsQ4;
+    } else {
+        g_runtime->componentCostUsQ4 = g_runtime->componentCostUsQ4 - (g_runtime->componentCostUsQ4 >> 3) + (costUsQ4 >> 3);
+    }
+}
+static unsigned getDeadlineCheckInterval(uint32_t remainingUs) {
+    uint32_t costUsQ4 = g_runtime->componentCostUsQ4 > 0 ? g_runtime->componentCostUsQ4 : 1;
+    uint32_t interval = (remainingUs << 3) / costUsQ4;
+    if (interval < 1) {
+        return 1;
+    }
+    if (interval > FLOW_TICK_MAX_CHECK_INTERVAL) {
+        return FLOW_TICK_MAX_CHECK_INTERVAL;
+    }
+    return interval;
+}
+static void recordTickOverrun(uint32_t overrunUs, uint16_t componentType) {
+    g_runtime->tickOverrunStats.numOverruns++;
+    if (overrunUs > g_runtime->tickOverrunStats.maxOverrunUs) {
+        g_runtime->tickOverrunStats.maxOverrunUs = overrunUs;
+    }
+    unsigned bucket = 0;
+    while (bucket < TICK_OVERRUN_NUM_BUCKETS - 1 && overrunUs >= TICK_OVERRUN_BUCKET_LIMITS_US[bucket]) {
+        bucket++;
+    }
+    g_runtime->tickOverrunStats.histogram[bucket]++;
+    for (unsigned i = 0; i < g_runtime->tickOverrunStats.numComponentTypes; i++) {
+        auto &componentStats = g_runtime->tickOverrunStats.components[i];
+        if (componentStats.componentType == componentType) {
+            componentStats.numOverruns++;
+            if (overrunUs > componentStats.maxOverrunUs) {
+                componentStats.maxOverrunUs = overrunUs;
+            }
+            return;
+        }
+    }
+    if (g_runtime->tickOverrunStats.numComponentTypes < TICK_OVERRUN_MAX_COMPONENT_TYPES) {
+        auto &componentStats = g_runtime->tickOverrunStats.components[g_runtime->tickOverrunStats.numComponentTypes++];
+        componentStats.componentType = componentType;
+        componentStats.numOverruns = 1;
+        componentStats.maxOverrunUs = overrunUs;
+    } else {
+        g_runtime->tickOverrunStats.numOtherComponentOverruns++;
+    }
+}
+void setTickBudget(uint32_t microseconds) {
+    g_runtime->tickBudgetUs = microseconds > 0 ? microseconds : 1;
+}
+uint32_t getTickBudget() {
+    return g_runtime->tickBudgetUs;
+}
+const TickOverrunStats &getTickOverrunStats() {
+    g_runtime->tickOverrunStats.averageComponentCostUs = g_runtime->componentCostUsQ4 >> 4;
+    return g_runtime->tickOverrunStats;
+}
+void resetTickOverrunStats() {
+    memset(&g_runtime->tickOverrunStats, 0, sizeof(g_runtime->tickOverrunStats));
+}
 unsigned start(Assets *assets) {
 	auto flowDefinition = static_cast<FlowDefinition *>(assets->flowDefinition);
 	if (flowDefinition->flows.count == 0) {
 		return 0;
 	}
-    g_isStopped = false;
-    g_isStopping = false;
+    g_runtime->isStopped = false;
+    g_runtime->isStopping = false;
+    g_runtime->numTracedFlowStates = 0;
+    TraceEngineScope traceEngineScope(true);
+    if (g_runtime->traceMode != TRACE_MODE_OFF) {
+        traceStart(assets);
+    }
     initGlobalVariables(assets);
 	queueReset();
+    timerWheelReset();
     watchListReset();
+    resetTickOverrunStats();
 	scpiComponentInitHook();
 	onStarted(assets);
 	return 1;
 }
 void tick() {
+    auto runtime = g_runtime;
+    if (runtime->traceMode == TRACE_MODE_RECORD) {
+        recordTraceTick();
+    }
+    TraceEngineScope traceEngineScope(true);
 	if (isFlowStopped()) {
 		return;
 	}
-    if (g_isStopping) {
+    if (runtime->isStopping) {
         doStop();
         return;
     }
 	uint32_t startTickCount = millis();
+    visitTimerWheel(startTickCount);
+#if EEZ_FLOW_PARALLEL_ACTIONS
+    visitParallelActions();
+#endif
+    queueSampleDepth();
+    uint32_t startTickUs = micros();
+    uint32_t lastCheckUs = startTickUs;
+    unsigned numExecuted = 0;
+    unsigned numExecutedSinceCheck = 0;
+    unsigned checkCountdown = 1;
+    uint16_t lastComponentType = 0;
     auto n = getQueueSize();
-    for (size_t i = 0; i < n || g_numContinuousTaskInQueue > 0; i++) {
+    resetQueueLaneVisits();
+    for (size_t i = 0; i < n || runtime->numContinuousTaskInQueue > 0; i++) {
 		FlowState *flowState;
 		unsigned componentIndex;
         bool continuousTask;
@@ -6172,7 +7638,9 @@ void tick() {
 		if (!continuousTask && !canExecuteStep(flowState, componentIndex)) {
 			break;
 		}
+        runtime->currentQueueLane = getNextTaskQueueLane();
 		removeNextTaskFromQueue();
+        lastComponentType = flowState->flow->components[componentIndex]->type;
         flowState->executingComponentIndex = componentIndex;
         if (flowState->error) {
             deallocateComponentExecutionState(flowState, componentIndex);
@@ -6191,38 +7659,91 @@ void tick() {
                 executeComponent(flowState, componentIndex);
             }
         }
-        if (isFlowStopped() || g_isStopping) {
+        if (isFlowStopped() || runtime->isStopping) {
             break;
         }
         resetSequenceInputs(flowState);
         if (canFreeFlowState(flowState)) {
             freeFlowState(flowState);
         }
-        if ((i + 1) % 5 == 0) {
-            if (millis() - startTickCount >= FLOW_TICK_MAX_DURATION_MS) {
+        numExecuted++;
+        numExecutedSinceCheck++;
+        if (--checkCountdown == 0) {
+            uint32_t nowUs = micros();
+            updateComponentCost(nowUs - lastCheckUs, numExecutedSinceCheck);
+            lastCheckUs = nowUs;
+            numExecutedSinceCheck = 0;
+            uint32_t elapsedUs = nowUs - startTickUs;
+            if (elapsedUs >= runtime->tickBudgetUs) {
                 break;
             }
+            checkCountdown = getDeadlineCheckInterval(runtime->tickBudgetUs - elapsedUs);
         }
 	}
+    if (numExecuted > 0) {
+        uint32_t elapsedUs = (numExecutedSinceCheck > 0 ? micros() : lastCheckUs) - startTickUs;
+        runtime->tickOverrunStats.numTicks++;
+        if (elapsedUs > runtime->tickBudgetUs) {
+            recordTickOverrun(elapsedUs - runtime->tickBudgetUs, lastComponentType);
+        }
+    }
+    runtime->currentQueueLane = QUEUE_LANE_NORMAL;
+    resetQueueLaneVisits();
     visitWatchList();
+    onQueueStats();
 	finishToDebuggerMessageHook();
 }
+uint32_t getNextWakeup() {
+	if (isFlowStopped()) {
+		return NO_WAKEUP;
+	}
+    if (g_runtime->isStopping || g_runtime->numContinuousTaskInQueue > 0) {
+        return 0;
+    }
+    uint32_t wakeup = NO_WAKEUP;
+    if (getQueueSize() > 0 || !isWatchListEmpty()) {
+        wakeup = FLOW_TICK_MAX_DURATION_MS;
+    }
+#if EEZ_FLOW_PARALLEL_ACTIONS
+    if (g_runtime->numParallelActionsInFlight > 0) {
+        wakeup = 1;
+    }
+#endif
+    uint32_t deadline;
+    if (timerWheelGetNextDeadline(deadline)) {
+        int32_t delta = (int32_t)(deadline - millis());
+        if (delta <= 0) {
+            return 0;
+        }
+        if ((uint32_t)delta < wakeup) {
+            wakeup = (uint32_t)delta;
+        }
+    }
+    return wakeup;
+}
 void stop() {
-    g_isStopping = true;
+    if (isTracingExternalCall()) {
+        recordTraceStop();
+    }
+    g_runtime->isStopping = true;
 }
 void doStop() {
     onStopped();
     finishToDebuggerMessageHook();
-    g_debuggerIsConnected = false;
-    freeAllChildrenFlowStates(g_firstFlowState);
-    g_firstFlowState = nullptr;
-    g_lastFlowState = nullptr;
-    g_isStopped = true;
+    g_runtime->debuggerIsConnected = false;
+#if EEZ_FLOW_PARALLEL_ACTIONS
+    cancelParallelActions();
+#endif
+    freeAllChildrenFlowStates(g_runtime->firstFlowState);
+    g_runtime->firstFlowState = nullptr;
+    g_runtime->lastFlowState = nullptr;
+    g_runtime->isStopped = true;
 	queueReset();
+    timerWheelReset();
     watchListReset();
 }
 bool isFlowStopped() {
-    return g_isStopped;
+    return g_runtime->isStopped;
 }
 #if EEZ_OPTION_GUI
 FlowState *getPageFlowState(Assets *assets, int16_t pageIndex, const WidgetCursor &widgetCursor) {
@@ -6243,7 +7764,7 @@ FlowState *getPageFlowState(Assets *assets, int16_t pageIndex, const WidgetCurso
 		auto page = assets->pages[pageIndex];
 		if (!(page->flags & PAGE_IS_USED_AS_USER_WIDGET)) {
             FlowState *flowState;
-            for (flowState = g_firstFlowState; flowState; flowState = flowState->nextSibling) {
+            for (flowState = g_runtime->firstFlowState; flowState; flowState = flowState->nextSibling) {
                 if (flowState->flowIndex == pageIndex) {
                     break;
                 }
@@ -6265,7 +7786,7 @@ FlowState *getPageFlowState(Assets *assets, int16_t pageIndex) {
 		return nullptr;
 	}
     FlowState *flowState;
-    for (flowState = g_firstFlowState; flowState; flowState = flowState->nextSibling) {
+    for (flowState = g_runtime->firstFlowState; flowState; flowState = flowState->nextSibling) {
         if (flowState->flowIndex == pageIndex) {
             break;
         }
@@ -6280,21 +7801,24 @@ int getPageIndex(FlowState *flowState) {
 	return flowState->flowIndex;
 }
 Value getGlobalVariable(uint32_t globalVariableIndex) {
-    return getGlobalVariable(g_mainAssets, globalVariableIndex);
+    return getGlobalVariable(g_runtime->mainAssets, globalVariableIndex);
 }
 Value getGlobalVariable(Assets *assets, uint32_t globalVariableIndex) {
     if (globalVariableIndex >= 0 && globalVariableIndex < assets->flowDefinition->globalVariables.count) {
-        return g_globalVariables ? g_globalVariables->values[globalVariableIndex] : *assets->flowDefinition->globalVariables[globalVariableIndex];
+        return g_runtime->globalVariables ? g_runtime->globalVariables->values[globalVariableIndex] : *assets->flowDefinition->globalVariables[globalVariableIndex];
     }
     return Value();
 }
 void setGlobalVariable(uint32_t globalVariableIndex, const Value &value) {
-    setGlobalVariable(g_mainAssets, globalVariableIndex, value);
+    setGlobalVariable(g_runtime->mainAssets, globalVariableIndex, value);
 }
 void setGlobalVariable(Assets *assets, uint32_t globalVariableIndex, const Value &value) {
+    if (isTracingExternalCall()) {
+        recordTraceSetGlobalVariable(assets, globalVariableIndex, value);
+    }
     if (globalVariableIndex >= 0 && globalVariableIndex < assets->flowDefinition->globalVariables.count) {
-        if (g_globalVariables) {
-            g_globalVariables->values[globalVariableIndex] = value;
+        if (g_runtime->globalVariables) {
+            g_runtime->globalVariables->values[globalVariableIndex] = value;
         } else {
             *assets->flowDefinition->globalVariables[globalVariableIndex] = value;
         }
@@ -6304,23 +7828,30 @@ Value getUserProperty(unsigned propertyIndex) {
     Value value;
     char errorMessage[64];
     snprintf(errorMessage, sizeof(errorMessage), "Failed to evaluate property #%d in CallAction", (int)(propertyIndex + 1));
-    evalProperty(g_executeActionFlowState, g_executeActionComponentIndex, propertyIndex, value, nullptr);
+    evalProperty(g_runtime->executeActionFlowState, g_runtime->executeActionComponentIndex, propertyIndex, value, nullptr);
     return value;
 }
 void setUserProperty(unsigned propertyIndex, const Value &value) {
+    if (isTracingExternalCall()) {
+        recordTraceSetUserProperty(propertyIndex, value);
+        TraceEngineScope traceEngineScope(true);
+        setUserProperty(propertyIndex, value);
+        return;
+    }
     char errorMessage[64];
     snprintf(errorMessage, sizeof(errorMessage), "Failed to evaluate assignable property #%d in CallAction", (int)(propertyIndex + 1));
     Value dstValue;
-    if (!evalAssignableProperty(g_executeActionFlowState, g_executeActionComponentIndex, propertyIndex, dstValue, errorMessage)) {
+    if (!evalAssignableProperty(g_runtime->executeActionFlowState, g_runtime->executeActionComponentIndex, propertyIndex, dstValue, errorMessage)) {
         return;
     }
-    assignValue(g_executeActionFlowState, g_executeActionComponentIndex, dstValue, value);
+    assignValue(g_runtime->executeActionFlowState, g_runtime->executeActionComponentIndex, dstValue, value);
 }
 #if EEZ_OPTION_GUI
 void executeFlowAction(const WidgetCursor &widgetCursor, int16_t actionId, void *param) {
 	if (isFlowStopped()) {
 		return;
 	}
+    QueueLaneScope queueLaneScope(QUEUE_LANE_UI);
 	auto flowState = widgetCursor.flowState;
 	actionId = -actionId - 1;
 	auto flow = flowState->flow;
@@ -6599,79 +8130,527 @@ void (*onFlowErrorHook)(FlowState *flowState, int componentIndex, const char *er
 } 
 } 
 // -----------------------------------------------------------------------------
-// flow/lvgl_api.cpp
+// flow/json.cpp
 // -----------------------------------------------------------------------------
-#if defined(EEZ_FOR_LVGL)
-#include <stdio.h>
-static void replacePageHook(int16_t pageId, uint32_t animType, uint32_t speed, uint32_t delay);
-extern "C" void create_screens();
-extern "C" void tick_screen(int screen_index);
-static lv_obj_t **g_objects;
-static size_t g_numObjects;
-static const ext_img_desc_t *g_images;
-static size_t g_numImages;
-static ActionExecFunc *g_actions;
-int16_t g_currentScreen = -1;
-static lv_obj_t *getLvglObjectFromIndex(int32_t index) {
-    if (index == -1) {
-        return 0;
+#include <stdlib.h>
+#if !defined(EEZ_DASHBOARD_API)
+namespace eez {
+namespace flow {
+enum JsonType {
+    JSON_TYPE_NULL,
+    JSON_TYPE_FALSE,
+    JSON_TYPE_TRUE,
+    JSON_TYPE_NUMBER,
+    JSON_TYPE_STRING,
+    JSON_TYPE_ARRAY,
+    JSON_TYPE_OBJECT
+};
+enum JsonState {
+    JSON_STATE_NOT_PARSED,
+    JSON_STATE_PARSED,
+    JSON_STATE_ERROR
+};
+struct JsonTapeEntry {
+    uint8_t type;
+    uint32_t offset;
+    uint32_t next;
+    uint32_t count;
+};
+struct JsonLookupCacheEntry {
+    uint32_t parent;
+    uint32_t key;
+    uint32_t child;
+};
+struct JsonDocument {
+    uint32_t refCounter;
+    JsonState state;
+    char *text;
+    uint32_t textLen;
+    JsonTapeEntry *tape;
+    uint32_t tapeSize;
+    uint32_t tapeCapacity;
+    JsonLookupCacheEntry cache[EEZ_FLOW_JSON_LOOKUP_CACHE_SIZE];
+};
+JsonRef::~JsonRef() {
+    if (--document->refCounter == 0) {
+        if (document->tape) {
+            eez::free(document->tape);
+        }
+        eez::free(document->text);
+        eez::free(document);
     }
-    return g_objects[index];
 }
-static const void *getLvglImageByName(const char *name) {
-    for (size_t imageIndex = 0; imageIndex < g_numImages; imageIndex++) {
-        if (strcmp(g_images[imageIndex].name, name) == 0) {
-            return g_images[imageIndex].img_dsc;
-        }
+static Value makeJsonValue(JsonDocument *document, uint32_t node, uint32_t id) {
+    auto jsonRef = ObjectAllocator<JsonRef>::allocate(id);
+    if (jsonRef == nullptr) {
+        return Value(0, VALUE_TYPE_NULL);
     }
-    return 0;
+    jsonRef->document = document;
+    jsonRef->node = node;
+    jsonRef->refCounter = 1;
+    document->refCounter++;
+    Value value;
+    value.type = VALUE_TYPE_JSON;
+    value.options = VALUE_OPTIONS_REF;
+    value.refValue = jsonRef;
+    return value;
 }
-static void executeLvglAction(int actionIndex) {
-    g_actions[actionIndex](0);
+Value jsonParse(const char *text, int len, uint32_t id) {
+    if (len == -1) {
+        len = strlen(text);
+    }
+    auto document = (JsonDocument *)eez::alloc(sizeof(JsonDocument), id);
+    if (document == nullptr) {
+        return Value(0, VALUE_TYPE_NULL);
+    }
+    document->text = (char *)eez::alloc(len + 1, id + 1);
+    if (document->text == nullptr) {
+        eez::free(document);
+        return Value(0, VALUE_TYPE_NULL);
+    }
+    stringCopyLength(document->text, len + 1, text, len);
+    document->text[len] = 0;
+    document->textLen = len;
+    document->refCounter = 0;
+    document->state = JSON_STATE_NOT_PARSED;
+    document->tape = nullptr;
+    document->tapeSize = 0;
+    document->tapeCapacity = 0;
+    memset(document->cache, 0, sizeof(document->cache));
+    auto value = makeJsonValue(document, 0, id + 2);
+    if (value.type == VALUE_TYPE_NULL) {
+        eez::free(document->text);
+        eez::free(document);
+    }
+    return value;
 }
-#if !defined(EEZ_LVGL_SCREEN_STACK_SIZE)
-#define EEZ_LVGL_SCREEN_STACK_SIZE 10
-#endif
-int16_t g_screenStack[EEZ_LVGL_SCREEN_STACK_SIZE];
-unsigned g_screenStackPosition = 0;
-extern "C" int16_t eez_flow_get_current_screen() {
-    return g_currentScreen + 1;
+static int addTapeEntry(JsonDocument *document, JsonType type, uint32_t offset) {
+    if (document->tapeSize == document->tapeCapacity) {
+        uint32_t tapeCapacity = document->tapeCapacity ? 2 * document->tapeCapacity : document->textLen / 8 + 8;
+        auto tape = (JsonTapeEntry *)eez::alloc(tapeCapacity * sizeof(JsonTapeEntry), 0x4d1c7a02);
+        if (tape == nullptr) {
+            return -1;
+        }
+        if (document->tape) {
+            memcpy(tape, document->tape, document->tapeSize * sizeof(JsonTapeEntry));
+            eez::free(document->tape);
+        }
+        document->tape = tape;
+        document->tapeCapacity = tapeCapacity;
+    }
+    auto &entry = document->tape[document->tapeSize];
+    entry.type = type;
+    entry.offset = offset;
+    entry.next = document->tapeSize + 1;
+    entry.count = 0;
+    return document->tapeSize++;
+}
+static int parseHex4(const char *p) {
+    int result = 0;
+    for (int i = 0; i < 4; i++) {
+        char c = p[i];
+        result <<= 4;
+        if (c >= '0' && c <= '9') {
+            result |= c - '0';
+        } else if (c >= 'a' && c <= 'f') {
+            result |= c - 'a' + 10;
+        } else if (c >= 'A' && c <= 'F') {
+            result |= c - 'A' + 10;
+        } else {
+            return -1;
+        }
+    }
+    return result;
 }
-extern "C" void eez_flow_set_screen(int16_t screenId, lv_scr_load_anim_t animType, uint32_t speed, uint32_t delay) {
-    g_screenStackPosition = 0;
-    eez::flow::replacePageHook(screenId, animType, speed, delay);
+static bool parseString(char *text, uint32_t &pos) {
+    char *src = text + pos;
+    char *dst = src;
+    while (true) {
+        char c = *src++;
+        if (c == '"') {
+            break;
+        }
+        if ((uint8_t)c < 0x20) {
+            return false;
+        }
+        if (c != '\\') {
+            *dst++ = c;
+            continue;
+        }
+        c = *src++;
+        if (c == 'b') {
+            *dst++ = '\b';
+        } else if (c == 'f') {
+            *dst++ = '\f';
+        } else if (c == 'n') {
+            *dst++ = '\n';
+        } else if (c == 'r') {
+            *dst++ = '\r';
+        } else if (c == 't') {
+            *dst++ = '\t';
+        } else if (c == '"' || c == '\\' || c == '/') {
+            *dst++ = c;
+        } else if (c == 'u') {
+            int32_t codePoint = parseHex4(src);
+            if (codePoint == -1) {
+                return false;
+            }
+            src += 4;
+            if (codePoint >= 0xD800 && codePoint <= 0xDBFF && src[0] == '\\' && src[1] == 'u') {
+                int32_t lowSurrogate = parseHex4(src + 2);
+                if (lowSurrogate >= 0xDC00 && lowSurrogate <= 0xDFFF) {
+                    codePoint = 0x10000 + ((codePoint - 0xD800) << 10) + (lowSurrogate - 0xDC00);
+                    src += 6;
+                }
+            }
+            dst = utf8catcodepoint(dst, codePoint, src - dst);
+            if (dst == nullptr) {
+                return false;
+            }
+        } else {
+            return false;
+        }
+    }
+    *dst = 0;
+    pos = src - text;
+    return true;
 }
-extern "C" void eez_flow_push_screen(int16_t screenId, lv_scr_load_anim_t animType, uint32_t speed, uint32_t delay) {
-    if (g_screenStackPosition == EEZ_LVGL_SCREEN_STACK_SIZE) {
-        for (unsigned i = 1; i < EEZ_LVGL_SCREEN_STACK_SIZE; i++) {
-            g_screenStack[i - 1] = g_screenStack[i];
+static bool parseNumber(const char *text, uint32_t &pos) {
+    uint32_t start = pos;
+    if (text[pos] == '-') {
+        pos++;
+    }
+    if (text[pos] < '0' || text[pos] > '9') {
+        return false;
+    }
+    while (text[pos] >= '0' && text[pos] <= '9') {
+        pos++;
+    }
+    if (text[pos] == '.') {
+        pos++;
+        if (text[pos] < '0' || text[pos] > '9') {
+            return false;
+        }
+        while (text[pos] >= '0' && text[pos] <= '9') {
+            pos++;
         }
-        g_screenStackPosition--;
     }
-    g_screenStack[g_screenStackPosition++] = g_currentScreen + 1;
-    eez::flow::replacePageHook(screenId, animType, speed, delay);
+    if (text[pos] == 'e' || text[pos] == 'E') {
+        pos++;
+        if (text[pos] == '+' || text[pos] == '-') {
+            pos++;
+        }
+        if (text[pos] < '0' || text[pos] > '9') {
+            return false;
+        }
+        while (text[pos] >= '0' && text[pos] <= '9') {
+            pos++;
+        }
+    }
+    return pos > start;
 }
-extern "C" void eez_flow_pop_screen(lv_scr_load_anim_t animType, uint32_t speed, uint32_t delay) {
-    if (g_screenStackPosition > 0) {
-        g_screenStackPosition--;
-        eez::flow::replacePageHook(g_screenStack[g_screenStackPosition], animType, speed, delay);
+static void skipWhitespace(const char *text, uint32_t &pos) {
+    while (text[pos] == ' ' || text[pos] == '\t' || text[pos] == '\n' || text[pos] == '\r') {
+        pos++;
     }
 }
-extern "C" void eez_flow_init(const uint8_t *assets, uint32_t assetsSize, lv_obj_t **objects, size_t numObjects, const ext_img_desc_t *images, size_t numImages, ActionExecFunc *actions) {
-    g_objects = objects;
-    g_numObjects = numObjects;
-    g_images = images;
-    g_numImages = numImages;
-    g_actions = actions;
-    eez::initAssetsMemory();
-    eez::loadMainAssets(assets, assetsSize);
-    eez::initOtherMemory();
+static bool buildTape(JsonDocument *document) {
+    char *text = document->text;
+    uint32_t pos = 0;
+    uint32_t containers[EEZ_FLOW_JSON_MAX_DEPTH];
+    int depth = 0;
+    bool expectKey = false;
+    skipWhitespace(text, pos);
+    while (true) {
+        if (expectKey) {
+            if (text[pos] != '"') {
+                return false;
+            }
+            pos++;
+            if (addTapeEntry(document, JSON_TYPE_STRING, pos) == -1 || !parseString(text, pos)) {
+                return false;
+            }
+            skipWhitespace(text, pos);
+            if (text[pos] != ':') {
+                return false;
+            }
+            pos++;
+            skipWhitespace(text, pos);
+            expectKey = false;
+        }
+        char c = text[pos];
+        if (c == '{' || c == '[') {
+            if (depth == EEZ_FLOW_JSON_MAX_DEPTH) {
+                return false;
+            }
+            int node = addTapeEntry(document, c == '{' ? JSON_TYPE_OBJECT : JSON_TYPE_ARRAY, pos);
+            if (node == -1) {
+                return false;
+            }
+            containers[depth++] = node;
+            pos++;
+            skipWhitespace(text, pos);
+            if (text[pos] != (c == '{' ? '}' : ']')) {
+                expectKey = c == '{';
+                continue;
+            }
+            depth--;
+            pos++;
+        } else if (c == '"') {
+            pos++;
+            if (addTapeEntry(document, JSON_TYPE_STRING, pos) == -1 || !parseString(text, pos)) {
+                return false;
+            }
+        } else if (c == '-' || (c >= '0' && c <= '9')) {
+            if (addTapeEntry(document, JSON_TYPE_NUMBER, pos) == -1 || !parseNumber(text, pos)) {
+                return false;
+            }
+        } else if (strncmp(text + pos, "true", 4) == 0) {
+            if (addTapeEntry(document, JSON_TYPE_TRUE, pos) == -1) {
+                return false;
+            }
+            pos += 4;
+        } else if (strncmp(text + pos, "false", 5) == 0) {
+            if (addTapeEntry(document, JSON_TYPE_FALSE, pos) == -1) {
+                return false;
+            }
+            pos += 5;
+        } else if (strncmp(text + pos, "null", 4) == 0) {
+            if (addTapeEntry(document, JSON_TYPE_NULL, pos) == -1) {
+                return false;
+            }
+            pos += 4;
+        } else {
+            return false;
+        }
+        while (true) {
+            skipWhitespace(text, pos);
+            if (depth == 0) {
+                return text[pos] == 0;
+            }
+            auto &container = document->tape[containers[depth - 1]];
+            container.count++;
+            if (text[pos] == ',') {
+                pos++;
+                skipWhitespace(text, pos);
+                expectKey = container.type == JSON_TYPE_OBJECT;
+                break;
+            }
+            if (text[pos] != (container.type == JSON_TYPE_OBJECT ? '}' : ']')) {
+                return false;
+            }
+            container.next = document->tapeSize;
+            depth--;
+            pos++;
+        }
+    }
+}
+static bool ensureParsed(JsonDocument *document) {
+    if (document->state == JSON_STATE_NOT_PARSED) {
+        document->state = buildTape(document) ? JSON_STATE_PARSED : JSON_STATE_ERROR;
+    }
+    return document->state == JSON_STATE_PARSED;
+}
+static Value getNodeValue(const Value &jsonValue, JsonDocument *document, uint32_t node) {
+    auto &entry = document->tape[node];
+    if (entry.type == JSON_TYPE_NULL) {
+        return Value(0, VALUE_TYPE_NULL);
+    }
+    if (entry.type == JSON_TYPE_FALSE || entry.type == JSON_TYPE_TRUE) {
+        return Value(entry.type == JSON_TYPE_TRUE, VALUE_TYPE_BOOLEAN);
+    }
+    if (entry.type == JSON_TYPE_NUMBER) {
+        char *end;
+        const char *str = document->text + entry.offset;
+        long long longValue = strtoll(str, &end, 10);
+        if (*end != '.' && *end != 'e' && *end != 'E' && longValue >= INT32_MIN && longValue <= INT32_MAX) {
+            return Value((int)longValue, VALUE_TYPE_INT32);
+        }
+        return Value(strtod(str, nullptr), VALUE_TYPE_DOUBLE);
+    }
+    if (entry.type == JSON_TYPE_STRING) {
+        return Value::makeStringSliceRef(jsonValue, document->text + entry.offset, 0x7e21a5c9);
+    }
+    return makeJsonValue(document, node, 0x7e21a5ca);
+}
+static uint32_t hashKey(const char *key) {
+    uint32_t hash = 2166136261u;
+    while (*key) {
+        hash = (hash ^ (uint8_t)*key++) * 16777619u;
+    }
+    return hash;
+}
+static uint32_t findChild(JsonDocument *document, uint32_t parent, const Value &property) {
+    auto &parentEntry = document->tape[parent];
+    uint32_t key;
+    const char *keyStr = nullptr;
+    if (parentEntry.type == JSON_TYPE_ARRAY) {
+        int err;
+        int index = property.toInt32(&err);
+        if (err || index < 0 || (uint32_t)index >= parentEntry.count) {
+            return 0;
+        }
+        key = index;
+    } else if (parentEntry.type == JSON_TYPE_OBJECT) {
+        keyStr = property.getString();
+        if (!keyStr) {
+            return 0;
+        }
+        key = hashKey(keyStr);
+    } else {
+        return 0;
+    }
+    auto &cacheEntry = document->cache[(key ^ (parent * 2654435761u)) % EEZ_FLOW_JSON_LOOKUP_CACHE_SIZE];
+    if (cacheEntry.child != 0 && cacheEntry.parent == parent && cacheEntry.key == key) {
+        if (!keyStr || strcmp(document->text + document->tape[cacheEntry.child - 1].offset, keyStr) == 0) {
+            return cacheEntry.child;
+        }
+    }
+    uint32_t child = 0;
+    uint32_t node = parent + 1;
+    if (!keyStr) {
+        uint32_t i = 0;
+        if (key > 0) {
+            auto &prevCacheEntry = document->cache[((key - 1) ^ (parent * 2654435761u)) % EEZ_FLOW_JSON_LOOKUP_CACHE_SIZE];
+            if (prevCacheEntry.child != 0 && prevCacheEntry.parent == parent && prevCacheEntry.key == key - 1) {
+                node = document->tape[prevCacheEntry.child].next;
+                i = key;
+            }
+        }
+        for (; i < key; i++) {
+            node = document->tape[node].next;
+        }
+        child = node;
+    } else {
+        for (uint32_t i = 0; i < parentEntry.count; i++) {
+            if (strcmp(document->text + document->tape[node].offset, keyStr) == 0) {
+                child = node + 1;
+                break;
+            }
+            node = document->tape[node + 1].next;
+        }
+    }
+    if (child != 0) {
+        cacheEntry.parent = parent;
+        cacheEntry.key = key;
+        cacheEntry.child = child;
+    }
+    return child;
+}
+Value jsonGet(const Value &jsonValue, const Value &property) {
+    auto jsonRef = (JsonRef *)jsonValue.refValue;
+    auto document = jsonRef->document;
+    if (!ensureParsed(document)) {
+        return Value::makeError();
+    }
+    uint32_t child = findChild(document, jsonRef->node, property);
+    if (child == 0) {
+        return Value();
+    }
+    return getNodeValue(jsonValue, document, child);
+}
+int jsonArrayLength(const Value &jsonValue) {
+    auto jsonRef = (JsonRef *)jsonValue.refValue;
+    auto document = jsonRef->document;
+    if (!ensureParsed(document) || document->tape[jsonRef->node].type != JSON_TYPE_ARRAY) {
+        return -1;
+    }
+    return document->tape[jsonRef->node].count;
+}
+void jsonValueToText(const Value &jsonValue, char *text, int count) {
+    auto jsonRef = (JsonRef *)jsonValue.refValue;
+    auto document = jsonRef->document;
+    if (!ensureParsed(document)) {
+        snprintf(text, count, "json (invalid)");
+        return;
+    }
+    auto &entry = document->tape[jsonRef->node];
+    if (entry.type == JSON_TYPE_ARRAY) {
+        snprintf(text, count, "json array (%d elements)", (int)entry.count);
+    } else if (entry.type == JSON_TYPE_OBJECT) {
+        snprintf(text, count, "json object (%d members)", (int)entry.count);
+    } else {
+        auto value = getNodeValue(jsonValue, document, jsonRef->node);
+        value.toText(text, count);
+    }
+}
+} 
+} 
+#endif
+// -----------------------------------------------------------------------------
+// flow/lvgl_api.cpp
+// -----------------------------------------------------------------------------
+#if defined(EEZ_FOR_LVGL)
+#include <stdio.h>
+static void replacePageHook(int16_t pageId, uint32_t animType, uint32_t speed, uint32_t delay);
+extern "C" void create_screens();
+extern "C" void tick_screen(int screen_index);
+static lv_obj_t **g_objects;
+static size_t g_numObjects;
+static const ext_img_desc_t *g_images;
+static size_t g_numImages;
+static ActionExecFunc *g_actions;
+static lv_obj_t *getLvglObjectFromIndex(int32_t index) {
+    if (index == -1) {
+        return 0;
+    }
+    return g_objects[index];
+}
+static eez::AssetsNameTable g_imageNames;
+static const char *getLvglImageName(const void *items, uint32_t index) {
+    return ((const ext_img_desc_t *)items)[index].name;
+}
+static const void *getLvglImageByName(const char *name) {
+    auto imageIndex = eez::findAssetsNameTable(g_imageNames, name);
+    if (imageIndex == -1) {
+        return 0;
+    }
+    return g_images[imageIndex].img_dsc;
+}
+static void executeLvglAction(int actionIndex) {
+    g_actions[actionIndex](0);
+}
+extern "C" int16_t eez_flow_get_current_screen() {
+    return eez::flow::g_runtime->currentScreen + 1;
+}
+extern "C" void eez_flow_set_screen(int16_t screenId, lv_scr_load_anim_t animType, uint32_t speed, uint32_t delay) {
+    eez::flow::g_runtime->screenStackPosition = 0;
+    eez::flow::replacePageHook(screenId, animType, speed, delay);
+}
+extern "C" void eez_flow_push_screen(int16_t screenId, lv_scr_load_anim_t animType, uint32_t speed, uint32_t delay) {
+    auto runtime = eez::flow::g_runtime;
+    if (runtime->screenStackPosition == EEZ_LVGL_SCREEN_STACK_SIZE) {
+        for (unsigned i = 1; i < EEZ_LVGL_SCREEN_STACK_SIZE; i++) {
+            runtime->screenStack[i - 1] = runtime->screenStack[i];
+        }
+        runtime->screenStackPosition--;
+    }
+    runtime->screenStack[runtime->screenStackPosition++] = runtime->currentScreen + 1;
+    eez::flow::replacePageHook(screenId, animType, speed, delay);
+}
+extern "C" void eez_flow_pop_screen(lv_scr_load_anim_t animType, uint32_t speed, uint32_t delay) {
+    auto runtime = eez::flow::g_runtime;
+    if (runtime->screenStackPosition > 0) {
+        runtime->screenStackPosition--;
+        eez::flow::replacePageHook(runtime->screenStack[runtime->screenStackPosition], animType, speed, delay);
+    }
+}
+extern "C" void eez_flow_init(const uint8_t *assets, uint32_t assetsSize, lv_obj_t **objects, size_t numObjects, const ext_img_desc_t *images, size_t numImages, ActionExecFunc *actions) {
+    g_objects = objects;
+    g_numObjects = numObjects;
+    g_images = images;
+    g_numImages = numImages;
+    eez::buildAssetsNameTable(g_imageNames, images, numImages, getLvglImageName);
+    g_actions = actions;
+    eez::initAssetsMemory();
+    eez::loadMainAssets(assets, assetsSize);
+    eez::initOtherMemory();
     eez::initAllocHeap(eez::ALLOC_BUFFER, eez::ALLOC_BUFFER_SIZE);
     eez::flow::replacePageHook = replacePageHook;
     eez::flow::getLvglObjectFromIndexHook = getLvglObjectFromIndex;
     eez::flow::getLvglImageByNameHook = getLvglImageByName;
     eez::flow::executeLvglActionHook = executeLvglAction;
-    eez::flow::start(eez::g_mainAssets);
+    eez::flow::start(eez::flow::g_runtime->mainAssets);
     create_screens();
     replacePageHook(1, 0, 0, 0);
 }
@@ -6685,6 +8664,82 @@ extern "C" void eez_flow_init_styles(
 extern "C" void eez_flow_tick() {
     eez::flow::tick();
 }
+extern "C" uint32_t eez_flow_get_next_wakeup() {
+    return eez::flow::getNextWakeup();
+}
+extern "C" void eez_flow_set_flow_queue_lane(unsigned flowIndex, int lane) {
+    eez::flow::setFlowQueueLane(flowIndex, (eez::flow::QueueLane)lane);
+}
+extern "C" void eez_flow_set_tick_budget_us(uint32_t microseconds) {
+    eez::flow::setTickBudget(microseconds);
+}
+extern "C" void eez_flow_get_tick_overrun_stats(eez_flow_tick_overrun_stats_t *stats) {
+    auto &tickOverrunStats = eez::flow::getTickOverrunStats();
+    stats->num_ticks = tickOverrunStats.numTicks;
+    stats->num_overruns = tickOverrunStats.numOverruns;
+    stats->max_overrun_us = tickOverrunStats.maxOverrunUs;
+    stats->average_component_cost_us = tickOverrunStats.averageComponentCostUs;
+    for (unsigned i = 0; i < eez::flow::TICK_OVERRUN_NUM_BUCKETS; i++) {
+        stats->histogram[i] = tickOverrunStats.histogram[i];
+    }
+    for (unsigned i = 0; i < tickOverrunStats.numComponentTypes; i++) {
+        stats->component_types[i] = tickOverrunStats.components[i].componentType;
+        stats->component_overruns[i] = tickOverrunStats.components[i].numOverruns;
+    }
+    stats->num_component_types = tickOverrunStats.numComponentTypes;
+    stats->other_component_overruns = tickOverrunStats.numOtherComponentOverruns;
+}
+extern "C" void *eez_flow_runtime_create() {
+    return eez::flow::createRuntime();
+}
+extern "C" void eez_flow_runtime_destroy(void *runtime) {
+    eez::flow::destroyRuntime((eez::flow::Runtime *)runtime);
+}
+extern "C" void *eez_flow_runtime_set_current(void *runtime) {
+    return eez::flow::setCurrentRuntime((eez::flow::Runtime *)runtime);
+}
+extern "C" bool eez_flow_checkpoint_save(uint8_t *buffer, uint32_t buffer_size, uint32_t *checkpoint_size) {
+    size_t checkpointSize;
+    bool result = eez::flow::saveCheckpoint(buffer, buffer_size, checkpointSize);
+    if (checkpoint_size) {
+        *checkpoint_size = checkpointSize;
+    }
+    return result;
+}
+extern "C" bool eez_flow_checkpoint_restore(const uint8_t *checkpoint, uint32_t checkpoint_size) {
+    return eez::flow::restoreCheckpoint(checkpoint, checkpoint_size);
+}
+extern "C" bool eez_flow_trace_record_start(eez_flow_trace_write_func_t write_func, void *context) {
+    return eez::flow::startTraceRecording(write_func, context);
+}
+extern "C" void eez_flow_trace_record_stop() {
+    eez::flow::stopTraceRecording();
+}
+extern "C" bool eez_flow_trace_replay_start(const uint8_t *trace, uint32_t trace_size) {
+    return eez::flow::startTraceReplay(trace, trace_size);
+}
+extern "C" int eez_flow_trace_replay_step() {
+    return eez::flow::replayTraceStep();
+}
+extern "C" void eez_flow_trace_replay_stop() {
+    eez::flow::stopTraceReplay();
+}
+#if EEZ_FLOW_PARALLEL_ACTIONS
+extern "C" void eez_flow_set_parallel_action_workers(unsigned num_workers) {
+    eez::flow::setParallelActionWorkers(num_workers);
+}
+#endif
+extern "C" void eez_flow_get_queue_stats(eez_flow_queue_stats_t *stats) {
+    eez::flow::QueueStats queueStats;
+    eez::flow::getQueueStats(queueStats);
+    stats->size = queueStats.size;
+    stats->capacity = queueStats.capacity;
+    stats->high_water_mark = queueStats.highWaterMark;
+    stats->average_depth = queueStats.averageDepth;
+    stats->overflows_avoided = queueStats.overflowsAvoided;
+    stats->chunk_allocations = queueStats.chunkAllocations;
+    stats->chunk_frees = queueStats.chunkFrees;
+}
 extern "C" bool eez_flow_is_stopped() {
     return eez::flow::isFlowStopped();
 }
@@ -6692,23 +8747,28 @@ namespace eez {
 ActionExecFunc g_actionExecFunctions[] = { 0 };
 }
 void replacePageHook(int16_t pageId, uint32_t animType, uint32_t speed, uint32_t delay) {
-    eez::flow::onPageChanged(g_currentScreen + 1, pageId);
-    g_currentScreen = pageId - 1;
-    lv_scr_load_anim(getLvglObjectFromIndex(g_currentScreen), (lv_scr_load_anim_t)animType, speed, delay, false);
+    auto runtime = eez::flow::g_runtime;
+    eez::flow::onPageChanged(runtime->currentScreen + 1, pageId);
+    runtime->currentScreen = pageId - 1;
+    lv_scr_load_anim(getLvglObjectFromIndex(runtime->currentScreen), (lv_scr_load_anim_t)animType, speed, delay, false);
 }
 extern "C" void flowOnPageLoaded(unsigned pageIndex) {
-    eez::flow::getPageFlowState(eez::g_mainAssets, pageIndex);
+    eez::flow::getPageFlowState(eez::flow::g_runtime->mainAssets, pageIndex);
 }
 extern "C" void flowPropagateValue(void *flowState, unsigned componentIndex, unsigned outputIndex) {
+    eez::flow::QueueLaneScope queueLaneScope(eez::flow::QUEUE_LANE_UI);
     eez::flow::propagateValue((eez::flow::FlowState *)flowState, componentIndex, outputIndex);
 }
 extern "C" void flowPropagateValueInt32(void *flowState, unsigned componentIndex, unsigned outputIndex, int32_t value) {
+    eez::flow::QueueLaneScope queueLaneScope(eez::flow::QUEUE_LANE_UI);
     eez::flow::propagateValue((eez::flow::FlowState *)flowState, componentIndex, outputIndex, eez::Value((int)value, eez::VALUE_TYPE_INT32));
 }
 extern "C" void flowPropagateValueUint32(void *flowState, unsigned componentIndex, unsigned outputIndex, uint32_t value) {
+    eez::flow::QueueLaneScope queueLaneScope(eez::flow::QUEUE_LANE_UI);
     eez::flow::propagateValue((eez::flow::FlowState *)flowState, componentIndex, outputIndex, eez::Value(value, eez::VALUE_TYPE_UINT32));
 }
 extern "C" void flowPropagateValueLVGLEvent(void *flowState, unsigned componentIndex, unsigned outputIndex, lv_event_t *event) {
+    eez::flow::QueueLaneScope queueLaneScope(eez::flow::QUEUE_LANE_UI);
     lv_event_code_t event_code = lv_event_get_code(event);
     uint32_t code = (uint32_t)event_code;
     void *currentTarget = (void *)lv_event_get_current_target(event);
@@ -6841,7 +8901,7 @@ extern "C" float getTimelinePosition(void *flowState) {
 }
 void *getFlowState(void *flowState, unsigned userWidgetComponentIndexOrPageIndex) {
     if (!flowState) {
-        return eez::flow::getPageFlowState(eez::g_mainAssets, userWidgetComponentIndexOrPageIndex);
+        return eez::flow::getPageFlowState(eez::flow::g_runtime->mainAssets, userWidgetComponentIndexOrPageIndex);
     }
     auto executionState = (eez::flow::LVGLUserWidgetExecutionState *)((eez::flow::FlowState *)flowState)->componenentExecutionStates[userWidgetComponentIndexOrPageIndex];
     if (!executionState) {
@@ -7553,7 +9613,7 @@ void do_OPERATION_TYPE_FLOW_IS_PAGE_ACTIVE(EvalStack &stack) {
     auto pageIndex = getPageIndex(stack.flowState);
     if (pageIndex >= 0) {
         int16_t pageId = (int16_t)(pageIndex + 1);
-        if (stack.flowState->assets == g_externalAssets) {
+        if (stack.flowState->assets == g_runtime->externalAssets) {
             pageId = -pageId;
         }
         for (int16_t appContextId = 0; ; appContextId++) {
@@ -7570,7 +9630,7 @@ void do_OPERATION_TYPE_FLOW_IS_PAGE_ACTIVE(EvalStack &stack) {
     stack.push(Value(isActive, VALUE_TYPE_BOOLEAN));
 #elif defined(EEZ_FOR_LVGL)
     auto pageIndex = getPageIndex(stack.flowState);
-    stack.push(Value(pageIndex == g_currentScreen, VALUE_TYPE_BOOLEAN));
+    stack.push(Value(pageIndex == g_runtime->currentScreen, VALUE_TYPE_BOOLEAN));
 #else
     stack.push(Value::makeError());
 #endif 
@@ -7654,12 +9714,12 @@ void do_OPERATION_TYPE_FLOW_TRANSLATE(EvalStack &stack) {
         stack.push(Value::makeError());
         return;
     }
-    int languageIndex = g_selectedLanguage;
+    int languageIndex = g_runtime->selectedLanguage;
     auto &languages = stack.flowState->assets->languages;
     if (languageIndex >= 0 && languageIndex < (int)languages.count) {
-        auto &translations = languages[languageIndex]->translations;
-        if (textResourceIndex >= 0 && textResourceIndex < (int)translations.count) {
-            stack.push(translations[textResourceIndex]);
+        auto translations = getLanguageTranslations(stack.flowState->assets, languageIndex);
+        if (translations && textResourceIndex >= 0 && textResourceIndex < (int)translations->count) {
+            stack.push((*translations)[textResourceIndex]);
             return;
         }
     }
@@ -7961,6 +10021,25 @@ void do_OPERATION_TYPE_DATE_MAKE(EvalStack &stack) {
     auto date = (double)date::makeDate(year, month, day, hours, minutes, seconds, milliseconds);
     stack.push(Value(date, VALUE_TYPE_DATE));
 }
+void do_OPERATION_TYPE_DATE_BREAK(EvalStack &stack) {
+    auto a = stack.pop().getValue();
+    if (a.isError()) {
+        stack.push(a);
+        return;
+    }
+    if (a.getType() != VALUE_TYPE_DATE) {
+        stack.push(Value::makeError());
+        return;
+    }
+    int parts[7];
+    date::breakDate(a.getDouble(), parts[0], parts[1], parts[2], parts[3], parts[4], parts[5], parts[6]);
+    auto arrayValue = Value::makeArrayRef(7, defs_v3::ARRAY_TYPE_INTEGER, 0x6b2e0d4a);
+    auto array = arrayValue.getArray();
+    for (int i = 0; i < 7; i++) {
+        array->values[i] = Value(parts[i], VALUE_TYPE_INT32);
+    }
+    stack.push(arrayValue);
+}
 void do_OPERATION_TYPE_MATH_SIN(EvalStack &stack) {
     auto a = stack.pop().getValue();
     if (a.isError()) {
@@ -8583,27 +10662,37 @@ void do_OPERATION_TYPE_STRING_SPLIT(EvalStack &stack) {
         stack.push(Value::makeError());
         return;
     }
-    auto strLen = strlen(str);
-    char *strCopy = (char *)eez::alloc(strLen + 1, 0xea9d0bc0);
-    stringCopy(strCopy, strLen + 1, str);
-    size_t arraySize = 0;
-    char *token = strtok(strCopy, delim);
-    while (token != NULL) {
+    auto delimLen = strlen(delim);
+    if (delimLen == 0) {
+        auto arrayValue = Value::makeArrayRef(utf8len(str), VALUE_TYPE_STRING, 0xe82675d4);
+        auto array = arrayValue.getArray();
+        for (uint32_t i = 0; i < array->arraySize; i++) {
+            utf8_int32_t codePoint;
+            auto next = utf8codepoint(str, &codePoint);
+            array->values[i] = Value::makeStringRef(str, next - str, 0x45209ec0);
+            str = next;
+        }
+        stack.push(arrayValue);
+        return;
+    }
+    auto bufferValue = Value::makeStringRef(str, -1, 0xea9d0bc0);
+    if (bufferValue.type == VALUE_TYPE_NULL) {
+        stack.push(Value::makeError());
+        return;
+    }
+    char *buffer = ((StringRef *)bufferValue.refValue)->str;
+    size_t arraySize = 1;
+    for (char *p = buffer; (p = strstr(p, delim)) != nullptr; p += delimLen) {
+        *p = 0;
         arraySize++;
-        token = strtok(NULL, delim);
     }
-    eez::free(strCopy);
-    strCopy = (char *)eez::alloc(strLen + 1, 0xea9d0bc1);
-    stringCopy(strCopy, strLen + 1, str);
     auto arrayValue = Value::makeArrayRef(arraySize, VALUE_TYPE_STRING, 0xe82675d4);
     auto array = arrayValue.getArray();
-    int i = 0;
-    token = strtok(strCopy, delim);
-    while (token != NULL) {
-        array->values[i++] = Value::makeStringRef(token, -1, 0x45209ec0);
-        token = strtok(NULL, delim);
+    char *token = buffer;
+    for (size_t i = 0; i < arraySize; i++) {
+        array->values[i] = Value::makeStringSliceRef(bufferValue, token, 0x45209ec0);
+        token += strlen(token) + delimLen;
     }
-    eez::free(strCopy);
     stack.push(arrayValue);
 }
 void do_OPERATION_TYPE_STRING_FROM_CODE_POINT(EvalStack &stack) {
@@ -8664,15 +10753,17 @@ void do_OPERATION_TYPE_ARRAY_LENGTH(EvalStack &stack) {
         stack.push(Value(blobRef->len, VALUE_TYPE_UINT32));
         return;
     }
-#if defined(EEZ_DASHBOARD_API)
     if (a.isJson()) {
+#if defined(EEZ_DASHBOARD_API)
         int length = operationJsonArrayLength(a.getInt());
+#else
+        int length = jsonArrayLength(a);
+#endif
         if (length >= 0) {
             stack.push(Value(length, VALUE_TYPE_UINT32));
             return;
         }
     }
-#endif
     stack.push(Value::makeError());
 }
 void do_OPERATION_TYPE_ARRAY_SLICE(EvalStack &stack) {
@@ -8922,6 +11013,75 @@ void do_OPERATION_TYPE_CRYPTO_SHA256(EvalStack &stack) {
     stack.push(Value::makeError());
 #endif
 }
+void do_OPERATION_TYPE_CRYPTO_SHA256_INIT(EvalStack &stack) {
+#if EEZ_FOR_LVGL_SHA256_OPTION
+    auto result = Value::makeBlobRef(nullptr, sizeof(SHA256_CTX), 0x1f0c0c0d);
+    if (result.type == VALUE_TYPE_NULL) {
+        stack.push(Value::makeError());
+        return;
+    }
+    sha256_init((SHA256_CTX *)result.getBlob()->blob);
+    stack.push(result);
+#else
+    stack.push(Value::makeError());
+#endif
+}
+void do_OPERATION_TYPE_CRYPTO_SHA256_UPDATE(EvalStack &stack) {
+    auto ctxValue = stack.pop().getValue();
+    if (ctxValue.isError()) {
+        stack.push(ctxValue);
+        return;
+    }
+    auto value = stack.pop().getValue();
+    if (value.isError()) {
+        stack.push(value);
+        return;
+    }
+    const uint8_t *data;
+    uint32_t dataLen;
+    if (value.isString()) {
+        const char *str = value.getString();
+        data = (uint8_t *)str;
+        dataLen = strlen(str);
+    } else if (value.isBlob()) {
+        auto blobRef = value.getBlob();
+        data = blobRef->blob;
+        dataLen = blobRef->len;
+    } else {
+        stack.push(Value::makeError());
+        return;
+    }
+#if EEZ_FOR_LVGL_SHA256_OPTION
+    if (!ctxValue.isBlob() || ctxValue.getBlob()->len != sizeof(SHA256_CTX)) {
+        stack.push(Value::makeError());
+        return;
+    }
+    sha256_update((SHA256_CTX *)ctxValue.getBlob()->blob, data, dataLen);
+    stack.push(ctxValue);
+#else
+    stack.push(Value::makeError());
+#endif
+}
+void do_OPERATION_TYPE_CRYPTO_SHA256_FINAL(EvalStack &stack) {
+    auto ctxValue = stack.pop().getValue();
+    if (ctxValue.isError()) {
+        stack.push(ctxValue);
+        return;
+    }
+#if EEZ_FOR_LVGL_SHA256_OPTION
+    if (!ctxValue.isBlob() || ctxValue.getBlob()->len != sizeof(SHA256_CTX)) {
+        stack.push(Value::makeError());
+        return;
+    }
+    SHA256_CTX ctx = *(SHA256_CTX *)ctxValue.getBlob()->blob;
+    BYTE buf[SHA256_BLOCK_SIZE];
+    sha256_final(&ctx, buf);
+    auto result = Value::makeBlobRef(buf, SHA256_BLOCK_SIZE, 0x1f0c0c0e);
+    stack.push(result);
+#else
+    stack.push(Value::makeError());
+#endif
+}
 void do_OPERATION_TYPE_BLOB_ALLOCATE(EvalStack &stack) {
     auto sizeValue = stack.pop();
     if (sizeValue.isError()) {
@@ -8937,6 +11097,28 @@ void do_OPERATION_TYPE_BLOB_ALLOCATE(EvalStack &stack) {
     auto result = Value::makeBlobRef(nullptr, size, 0xd3de43f1);
     stack.push(result);
 }
+void do_OPERATION_TYPE_BLOB_CRC32(EvalStack &stack) {
+    auto value = stack.pop().getValue();
+    if (value.isError()) {
+        stack.push(value);
+        return;
+    }
+    const uint8_t *data;
+    uint32_t dataLen;
+    if (value.isString()) {
+        const char *str = value.getString();
+        data = (uint8_t *)str;
+        dataLen = strlen(str);
+    } else if (value.isBlob()) {
+        auto blobRef = value.getBlob();
+        data = blobRef->blob;
+        dataLen = blobRef->len;
+    } else {
+        stack.push(Value::makeError());
+        return;
+    }
+    stack.push(Value(crc32(data, dataLen), VALUE_TYPE_UINT32));
+}
 void do_OPERATION_TYPE_JSON_GET(EvalStack &stack) {
 #if defined(EEZ_DASHBOARD_API)
     auto jsonValue = stack.pop().getValue();
@@ -8955,12 +11137,8 @@ void do_OPERATION_TYPE_JSON_GET(EvalStack &stack) {
     }
     stack.push(Value::makeJsonMemberRef(jsonValue, propertyValue.toString(0xc73d02e7), 0xebcc230a));
 #else
-    stack.push(Value::makeError());
-#endif
-}
-void do_OPERATION_TYPE_JSON_CLONE(EvalStack &stack) {
-#if defined(EEZ_DASHBOARD_API)
     auto jsonValue = stack.pop().getValue();
+    auto propertyValue = stack.pop().getValue();
     if (jsonValue.isError()) {
         stack.push(jsonValue);
         return;
@@ -8969,11 +11147,61 @@ void do_OPERATION_TYPE_JSON_CLONE(EvalStack &stack) {
         stack.push(Value::makeError());
         return;
     }
-    stack.push(operationJsonClone(jsonValue.getInt()));
-#else
-    stack.push(Value::makeError());
-#endif
-}
+    if (propertyValue.isError()) {
+        stack.push(propertyValue);
+        return;
+    }
+    stack.push(jsonGet(jsonValue, propertyValue));
+#endif
+}
+void do_OPERATION_TYPE_JSON_CLONE(EvalStack &stack) {
+#if defined(EEZ_DASHBOARD_API)
+    auto jsonValue = stack.pop().getValue();
+    if (jsonValue.isError()) {
+        stack.push(jsonValue);
+        return;
+    }
+    if (jsonValue.type != VALUE_TYPE_JSON) {
+        stack.push(Value::makeError());
+        return;
+    }
+    stack.push(operationJsonClone(jsonValue.getInt()));
+#else
+    auto jsonValue = stack.pop().getValue();
+    if (jsonValue.isError()) {
+        stack.push(jsonValue);
+        return;
+    }
+    if (jsonValue.type != VALUE_TYPE_JSON) {
+        stack.push(Value::makeError());
+        return;
+    }
+    stack.push(jsonValue);
+#endif
+}
+void do_OPERATION_TYPE_JSON_PARSE(EvalStack &stack) {
+#if defined(EEZ_DASHBOARD_API)
+    stack.pop();
+    stack.push(Value::makeError());
+#else
+    auto textValue = stack.pop().getValue();
+    if (textValue.isError()) {
+        stack.push(textValue);
+        return;
+    }
+    auto text = textValue.getString();
+    if (!text) {
+        stack.push(Value::makeError());
+        return;
+    }
+    auto jsonValue = jsonParse(text, -1, 0x5a3f10b6);
+    if (jsonValue.type == VALUE_TYPE_NULL) {
+        stack.push(Value::makeError());
+        return;
+    }
+    stack.push(jsonValue);
+#endif
+}
 void do_OPERATION_TYPE_EVENT_GET_CODE(EvalStack &stack) {
 #if defined(EEZ_FOR_LVGL)
     auto eventValue = stack.pop().getValue();
@@ -9154,7 +11382,731 @@ EvalOperation g_evalOperations[] = {
     do_OPERATION_TYPE_EVENT_GET_KEY,
     do_OPERATION_TYPE_EVENT_GET_GESTURE_DIR,
     do_OPERATION_TYPE_EVENT_GET_ROTARY_DIFF,
+    do_OPERATION_TYPE_DATE_BREAK,
+    do_OPERATION_TYPE_JSON_PARSE,
+    do_OPERATION_TYPE_CRYPTO_SHA256_INIT,
+    do_OPERATION_TYPE_CRYPTO_SHA256_UPDATE,
+    do_OPERATION_TYPE_CRYPTO_SHA256_FINAL,
+    do_OPERATION_TYPE_BLOB_CRC32,
+};
+bool isPureOperation(uint16_t operation) {
+    if (operation <= defs_v3::OPERATION_TYPE_CONDITIONAL) {
+        return true;
+    }
+    switch (operation) {
+    case defs_v3::OPERATION_TYPE_FLOW_PARSE_INTEGER:
+    case defs_v3::OPERATION_TYPE_FLOW_PARSE_FLOAT:
+    case defs_v3::OPERATION_TYPE_FLOW_PARSE_DOUBLE:
+    case defs_v3::OPERATION_TYPE_FLOW_TO_INTEGER:
+    case defs_v3::OPERATION_TYPE_MATH_SIN:
+    case defs_v3::OPERATION_TYPE_MATH_COS:
+    case defs_v3::OPERATION_TYPE_MATH_POW:
+    case defs_v3::OPERATION_TYPE_MATH_LOG:
+    case defs_v3::OPERATION_TYPE_MATH_LOG10:
+    case defs_v3::OPERATION_TYPE_MATH_ABS:
+    case defs_v3::OPERATION_TYPE_MATH_FLOOR:
+    case defs_v3::OPERATION_TYPE_MATH_CEIL:
+    case defs_v3::OPERATION_TYPE_MATH_ROUND:
+    case defs_v3::OPERATION_TYPE_MATH_MIN:
+    case defs_v3::OPERATION_TYPE_MATH_MAX:
+    case defs_v3::OPERATION_TYPE_STRING_LENGTH:
+    case defs_v3::OPERATION_TYPE_STRING_SUBSTRING:
+    case defs_v3::OPERATION_TYPE_STRING_FIND:
+    case defs_v3::OPERATION_TYPE_STRING_FORMAT:
+    case defs_v3::OPERATION_TYPE_STRING_FORMAT_PREFIX:
+    case defs_v3::OPERATION_TYPE_STRING_PAD_START:
+    case defs_v3::OPERATION_TYPE_STRING_FROM_CODE_POINT:
+    case defs_v3::OPERATION_TYPE_STRING_CODE_POINT_AT:
+    case defs_v3::OPERATION_TYPE_ARRAY_LENGTH:
+        return true;
+    default:
+        return false;
+    }
+}
+} 
+} 
+// -----------------------------------------------------------------------------
+// flow/parallel.cpp
+// -----------------------------------------------------------------------------
+#if EEZ_FLOW_PARALLEL_ACTIONS
+#include <string.h>
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#endif
+namespace eez {
+namespace flow {
+#if EEZ_FLOW_PARALLEL_ACTIONS
+static const uint8_t PARALLEL_ACTION_STATE_UNKNOWN = 0;
+static const uint8_t PARALLEL_ACTION_STATE_ELIGIBLE = 1;
+static const uint8_t PARALLEL_ACTION_STATE_NOT_ELIGIBLE = 2;
+struct ParallelActionInfo {
+    uint8_t state;
+    uint16_t numGlobals;
+    uint16_t *globals;
+};
+struct ParallelActionEvent {
+    ParallelActionEvent *next;
+    int outputIndex;
+    bool isError;
+    Value value;
+};
+struct ParallelActionJob {
+    ParallelActionJob *prev;
+    ParallelActionJob *next;
+    Runtime *owner;
+    Assets *assets;
+    FlowState *flowState;
+    int parentFlowIndex;
+    unsigned componentIndex;
+    int flowIndex;
+    unsigned numInputs;
+    Value *inputs;
+    unsigned numUserProperties;
+    Value *userProperties;
+    GlobalVariables *globalVariables;
+    ParallelActionEvent *firstEvent;
+    ParallelActionEvent *lastEvent;
+};
+struct ParallelActionJobList {
+    ParallelActionJob *first;
+    ParallelActionJob *last;
 };
+struct ParallelActionWorker {
+    std::thread thread;
+    std::mutex mutex;
+    ParallelActionJobList jobs;
+};
+static ParallelActionWorker *g_parallelActionWorkers;
+static unsigned g_numParallelActionWorkers;
+static std::atomic<unsigned> g_nextParallelActionWorker;
+static std::mutex g_parallelActionMutex;
+static std::condition_variable g_parallelActionAvailable;
+static std::condition_variable g_parallelActionDone;
+static unsigned g_numQueuedParallelActions;
+static bool g_parallelActionWorkersStopping;
+static ParallelActionJobList g_doneParallelActions;
+static void appendParallelActionJob(ParallelActionJobList &list, ParallelActionJob *job) {
+    job->prev = list.last;
+    job->next = nullptr;
+    if (list.last) {
+        list.last->next = job;
+    } else {
+        list.first = job;
+    }
+    list.last = job;
+}
+static void removeParallelActionJob(ParallelActionJobList &list, ParallelActionJob *job) {
+    if (job->prev) {
+        job->prev->next = job->next;
+    } else {
+        list.first = job->next;
+    }
+    if (job->next) {
+        job->next->prev = job->prev;
+    } else {
+        list.last = job->prev;
+    }
+}
+static bool isParallelSafeOperation(uint16_t operation) {
+    if (isPureOperation(operation)) {
+        return true;
+    }
+    switch (operation) {
+    case defs_v3::OPERATION_TYPE_SYSTEM_GET_TICK:
+    case defs_v3::OPERATION_TYPE_FLOW_INDEX:
+    case defs_v3::OPERATION_TYPE_FLOW_MAKE_VALUE:
+    case defs_v3::OPERATION_TYPE_FLOW_MAKE_ARRAY_VALUE:
+    case defs_v3::OPERATION_TYPE_CRYPTO_SHA256:
+    case defs_v3::OPERATION_TYPE_DATE_NOW:
+    case defs_v3::OPERATION_TYPE_DATE_TO_STRING:
+    case defs_v3::OPERATION_TYPE_DATE_FROM_STRING:
+    case defs_v3::OPERATION_TYPE_DATE_GET_YEAR:
+    case defs_v3::OPERATION_TYPE_DATE_GET_MONTH:
+    case defs_v3::OPERATION_TYPE_DATE_GET_DAY:
+    case defs_v3::OPERATION_TYPE_DATE_GET_HOURS:
+    case defs_v3::OPERATION_TYPE_DATE_GET_MINUTES:
+    case defs_v3::OPERATION_TYPE_DATE_GET_SECONDS:
+    case defs_v3::OPERATION_TYPE_DATE_GET_MILLISECONDS:
+    case defs_v3::OPERATION_TYPE_DATE_MAKE:
+    case defs_v3::OPERATION_TYPE_DATE_BREAK:
+    case defs_v3::OPERATION_TYPE_STRING_SPLIT:
+    case defs_v3::OPERATION_TYPE_ARRAY_SLICE:
+    case defs_v3::OPERATION_TYPE_ARRAY_ALLOCATE:
+    case defs_v3::OPERATION_TYPE_ARRAY_APPEND:
+    case defs_v3::OPERATION_TYPE_ARRAY_INSERT:
+    case defs_v3::OPERATION_TYPE_ARRAY_REMOVE:
+    case defs_v3::OPERATION_TYPE_ARRAY_CLONE:
+    case defs_v3::OPERATION_TYPE_BLOB_CRC32:
+        return true;
+    default:
+        return false;
+    }
+}
+static bool canDetachValue(const Value &value) {
+    if (value.isArray()) {
+        auto array = value.getArray();
+        for (uint32_t elementIndex = 0; elementIndex < array->arraySize; elementIndex++) {
+            if (!canDetachValue(array->values[elementIndex])) {
+                return false;
+            }
+        }
+        return true;
+    }
+    switch (value.type) {
+    case VALUE_TYPE_UNDEFINED:
+    case VALUE_TYPE_NULL:
+    case VALUE_TYPE_BOOLEAN:
+    case VALUE_TYPE_INT8:
+    case VALUE_TYPE_UINT8:
+    case VALUE_TYPE_INT16:
+    case VALUE_TYPE_UINT16:
+    case VALUE_TYPE_INT32:
+    case VALUE_TYPE_UINT32:
+    case VALUE_TYPE_INT64:
+    case VALUE_TYPE_UINT64:
+    case VALUE_TYPE_FLOAT:
+    case VALUE_TYPE_DOUBLE:
+    case VALUE_TYPE_STRING:
+    case VALUE_TYPE_STRING_ASSET:
+    case VALUE_TYPE_STRING_REF:
+    case VALUE_TYPE_DATE:
+    case VALUE_TYPE_ENUM:
+        return true;
+    default:
+        return false;
+    }
+}
+static Value *getGlobalVariablePtr(FlowDefinition *flowDefinition, unsigned globalVariableIndex) {
+    if (g_runtime->globalVariables) {
+        return g_runtime->globalVariables->values + globalVariableIndex;
+    }
+    return flowDefinition->globalVariables[globalVariableIndex];
+}
+static bool scanParallelActionInstructions(FlowDefinition *flowDefinition, const uint8_t *instructions, bool isAssignable, uint8_t *usedGlobals) {
+    for (int i = 0; ; i += 2) {
+        uint16_t instruction = instructions[i] + (instructions[i + 1] << 8);
+        auto instructionType = instruction & EXPR_EVAL_INSTRUCTION_TYPE_MASK;
+        auto instructionArg = instruction & EXPR_EVAL_INSTRUCTION_PARAM_MASK;
+        if (instructionType == EXPR_EVAL_INSTRUCTION_TYPE_PUSH_GLOBAL_VAR) {
+            if (isAssignable || (uint32_t)instructionArg >= flowDefinition->globalVariables.count) {
+                return false;
+            }
+            usedGlobals[instructionArg] = 1;
+        } else if (instructionType == EXPR_EVAL_INSTRUCTION_TYPE_OPERATION) {
+            if (!isParallelSafeOperation(instructionArg)) {
+                return false;
+            }
+        } else if (instructionType == EXPR_EVAL_INSTRUCTION_TYPE_END) {
+            return true;
+        }
+    }
+}
+static bool scanParallelActionFlow(FlowDefinition *flowDefinition, int flowIndex, uint8_t *visitedFlows, uint8_t *usedGlobals) {
+    visitedFlows[flowIndex] = 1;
+    auto flow = flowDefinition->flows[flowIndex];
+    for (uint32_t componentIndex = 0; componentIndex < flow->components.count; componentIndex++) {
+        auto component = flow->components[componentIndex];
+        Flow *calledFlow = nullptr;
+        switch (component->type) {
+        case defs_v3::COMPONENT_TYPE_START_ACTION:
+        case defs_v3::COMPONENT_TYPE_END_ACTION:
+        case defs_v3::COMPONENT_TYPE_INPUT_ACTION:
+        case defs_v3::COMPONENT_TYPE_OUTPUT_ACTION:
+        case defs_v3::COMPONENT_TYPE_EVAL_EXPR_ACTION:
+        case defs_v3::COMPONENT_TYPE_SET_VARIABLE_ACTION:
+        case defs_v3::COMPONENT_TYPE_SWITCH_ACTION:
+        case defs_v3::COMPONENT_TYPE_COMPARE_ACTION:
+        case defs_v3::COMPONENT_TYPE_IS_TRUE_ACTION:
+        case defs_v3::COMPONENT_TYPE_CONSTANT_ACTION:
+        case defs_v3::COMPONENT_TYPE_ERROR_ACTION:
+        case defs_v3::COMPONENT_TYPE_CATCH_ERROR_ACTION:
+        case defs_v3::COMPONENT_TYPE_COUNTER_ACTION:
+        case defs_v3::COMPONENT_TYPE_LOOP_ACTION:
+        case defs_v3::COMPONENT_TYPE_NOOP_ACTION:
+        case defs_v3::COMPONENT_TYPE_COMMENT_ACTION:
+        case defs_v3::COMPONENT_TYPE_SORT_ARRAY_ACTION:
+        case defs_v3::COMPONENT_TYPE_LABEL_IN_ACTION:
+        case defs_v3::COMPONENT_TYPE_LABEL_OUT_ACTION:
+            break;
+        case defs_v3::COMPONENT_TYPE_CALL_ACTION_ACTION: {
+            auto calledFlowIndex = ((CallActionActionComponent *)component)->flowIndex;
+            if (calledFlowIndex < 0 || calledFlowIndex >= (int)flowDefinition->flows.count) {
+                return false;
+            }
+            calledFlow = flowDefinition->flows[calledFlowIndex];
+            if (!visitedFlows[calledFlowIndex] && !scanParallelActionFlow(flowDefinition, calledFlowIndex, visitedFlows, usedGlobals)) {
+                return false;
+            }
+            break;
+        }
+        default:
+            return false;
+        }
+        for (uint32_t propertyIndex = 0; propertyIndex < component->properties.count; propertyIndex++) {
+            bool isAssignable =
+                (component->type == defs_v3::COMPONENT_TYPE_LOOP_ACTION && propertyIndex == defs_v3::LOOP_ACTION_COMPONENT_PROPERTY_VARIABLE) ||
+                (calledFlow && propertyIndex < calledFlow->userPropertiesAssignable.count && calledFlow->userPropertiesAssignable.items[propertyIndex]);
+            if (!scanParallelActionInstructions(flowDefinition, component->properties[propertyIndex]->evalInstructions, isAssignable, usedGlobals)) {
+                return false;
+            }
+        }
+        if (component->type == defs_v3::COMPONENT_TYPE_SET_VARIABLE_ACTION) {
+            auto setVariableActionComponent = (SetVariableActionComponent *)component;
+            for (uint32_t entryIndex = 0; entryIndex < setVariableActionComponent->entries.count; entryIndex++) {
+                auto entry = setVariableActionComponent->entries[entryIndex];
+                if (
+                    !scanParallelActionInstructions(flowDefinition, entry->variable, true, usedGlobals) ||
+                    !scanParallelActionInstructions(flowDefinition, entry->value, false, usedGlobals)
+                ) {
+                    return false;
+                }
+            }
+        } else if (component->type == defs_v3::COMPONENT_TYPE_SWITCH_ACTION) {
+            auto switchActionComponent = (SwitchActionComponent *)component;
+            for (uint32_t testIndex = 0; testIndex < switchActionComponent->tests.count; testIndex++) {
+                auto test = switchActionComponent->tests[testIndex];
+                if (
+                    !scanParallelActionInstructions(flowDefinition, test->condition, false, usedGlobals) ||
+                    !scanParallelActionInstructions(flowDefinition, test->outputValue, false, usedGlobals)
+                ) {
+                    return false;
+                }
+            }
+        }
+    }
+    return true;
+}
+static void buildParallelActionInfo(ParallelActionInfo &info, FlowDefinition *flowDefinition, int flowIndex) {
+    info.state = PARALLEL_ACTION_STATE_NOT_ELIGIBLE;
+    auto flow = flowDefinition->flows[flowIndex];
+    for (uint32_t i = 0; i < flow->userPropertiesAssignable.count; i++) {
+        if (flow->userPropertiesAssignable.items[i]) {
+            return;
+        }
+    }
+    auto numFlows = flowDefinition->flows.count;
+    auto numGlobalVariables = flowDefinition->globalVariables.count;
+    auto visitedFlows = (uint8_t *)alloc(numFlows + numGlobalVariables, 0x7d3e2a51);
+    if (!visitedFlows) {
+        return;
+    }
+    auto usedGlobals = visitedFlows + numFlows;
+    memset(visitedFlows, 0, numFlows + numGlobalVariables);
+    if (scanParallelActionFlow(flowDefinition, flowIndex, visitedFlows, usedGlobals)) {
+        unsigned numGlobals = 0;
+        for (uint32_t i = 0; i < numGlobalVariables; i++) {
+            if (usedGlobals[i]) {
+                numGlobals++;
+            }
+        }
+        info.globals = numGlobals > 0 ? (uint16_t *)alloc(numGlobals * sizeof(uint16_t), 0x7d3e2a52) : nullptr;
+        if (numGlobals == 0 || info.globals) {
+            info.numGlobals = 0;
+            for (uint32_t i = 0; i < numGlobalVariables; i++) {
+                if (usedGlobals[i]) {
+                    info.globals[info.numGlobals] = i;
+                    info.numGlobals++;
+                }
+            }
+            info.state = PARALLEL_ACTION_STATE_ELIGIBLE;
+        }
+    }
+    free(visitedFlows);
+}
+static void freeParallelActionInfos() {
+    auto runtime = g_runtime;
+    if (runtime->parallelActionInfos) {
+        for (unsigned i = 0; i < runtime->numParallelActionInfos; i++) {
+            if (runtime->parallelActionInfos[i].globals) {
+                free(runtime->parallelActionInfos[i].globals);
+            }
+        }
+        free(runtime->parallelActionInfos);
+        runtime->parallelActionInfos = nullptr;
+        runtime->numParallelActionInfos = 0;
+    }
+    runtime->parallelActionInfosAssets = nullptr;
+}
+static ParallelActionInfo *getParallelActionInfo(Assets *assets, int flowIndex) {
+    auto runtime = g_runtime;
+    auto flowDefinition = static_cast<FlowDefinition *>(assets->flowDefinition);
+    if (runtime->parallelActionInfosAssets != assets) {
+        freeParallelActionInfos();
+        auto numFlows = flowDefinition->flows.count;
+        runtime->parallelActionInfos = (ParallelActionInfo *)alloc(numFlows * sizeof(ParallelActionInfo), 0x7d3e2a53);
+        if (!runtime->parallelActionInfos) {
+            return nullptr;
+        }
+        memset(runtime->parallelActionInfos, 0, numFlows * sizeof(ParallelActionInfo));
+        runtime->numParallelActionInfos = numFlows;
+        runtime->parallelActionInfosAssets = assets;
+    }
+    auto &info = runtime->parallelActionInfos[flowIndex];
+    if (info.state == PARALLEL_ACTION_STATE_UNKNOWN) {
+        buildParallelActionInfo(info, flowDefinition, flowIndex);
+    }
+    return &info;
+}
+static void freeParallelActionJob(ParallelActionJob *job) {
+    for (auto event = job->firstEvent; event; ) {
+        auto nextEvent = event->next;
+        event->~ParallelActionEvent();
+        free(event);
+        event = nextEvent;
+    }
+    if (job->globalVariables) {
+        for (uint32_t i = 0; i < job->globalVariables->count; i++) {
+            job->globalVariables->values[i].~Value();
+        }
+        free(job->globalVariables);
+    }
+    for (unsigned i = 0; i < job->numInputs + job->numUserProperties; i++) {
+        job->inputs[i].~Value();
+    }
+    free(job);
+}
+static ParallelActionJob *takeParallelActionJob(unsigned workerIndex) {
+    for (unsigned i = 0; i < g_numParallelActionWorkers; i++) {
+        auto &worker = g_parallelActionWorkers[(workerIndex + i) % g_numParallelActionWorkers];
+        std::lock_guard<std::mutex> lock(worker.mutex);
+        auto job = i == 0 ? worker.jobs.first : worker.jobs.last;
+        if (job) {
+            removeParallelActionJob(worker.jobs, job);
+            return job;
+        }
+    }
+    return nullptr;
+}
+static void runParallelActionJob(ParallelActionJob *job) {
+    auto runtime = g_runtime;
+    runtime->mainAssets = job->assets;
+    runtime->mainAssetsSections = job->assets == job->owner->mainAssets ? job->owner->mainAssetsSections : nullptr;
+    runtime->globalVariables = job->globalVariables;
+    runtime->isStopping = false;
+    runtime->isStopped = false;
+    queueReset();
+    auto proxyFlowState = initParallelActionProxyFlowState(job->assets, job->parentFlowIndex, job);
+    if (proxyFlowState) {
+        auto component = proxyFlowState->flow->components[job->componentIndex];
+        for (unsigned i = 0; i < job->numInputs; i++) {
+            setInputValue(proxyFlowState, component->inputs[i], job->inputs[i]);
+        }
+        auto actionFlowState = initActionFlowState(job->flowIndex, proxyFlowState, job->componentIndex, Value());
+        if (actionFlowState) {
+            for (unsigned i = 0; i < job->numUserProperties; i++) {
+                auto propValuePtr = actionFlowState->values + actionFlowState->flow->componentInputs.count + i;
+                *propValuePtr = job->userProperties[i];
+                onValueChanged(propValuePtr);
+            }
+            if (canFreeFlowState(actionFlowState)) {
+                freeFlowState(actionFlowState);
+                propagateValueThroughSeqout(proxyFlowState, job->componentIndex);
+            }
+            while (!isFlowStopped() && !runtime->isStopping && getQueueSize() > 0) {
+                tick();
+            }
+        }
+    }
+    freeAllChildrenFlowStates(runtime->firstFlowState);
+    runtime->firstFlowState = nullptr;
+    runtime->lastFlowState = nullptr;
+    queueReset();
+    timerWheelReset();
+    watchListReset();
+    runtime->isStopped = true;
+    runtime->mainAssetsSections = nullptr;
+    runtime->globalVariables = nullptr;
+}
+static void parallelActionWorkerMain(unsigned workerIndex) {
+    auto runtime = createRuntime();
+    runtime->isParallelActionWorker = true;
+    setCurrentRuntime(runtime);
+    while (true) {
+        ParallelActionJob *job;
+        {
+            std::unique_lock<std::mutex> lock(g_parallelActionMutex);
+            g_parallelActionAvailable.wait(lock, [] {
+                return g_numQueuedParallelActions > 0 || g_parallelActionWorkersStopping;
+            });
+            if (g_numQueuedParallelActions == 0) {
+                break;
+            }
+            g_numQueuedParallelActions--;
+            job = takeParallelActionJob(workerIndex);
+        }
+        runParallelActionJob(job);
+        {
+            std::lock_guard<std::mutex> lock(g_parallelActionMutex);
+            appendParallelActionJob(g_doneParallelActions, job);
+        }
+        g_parallelActionDone.notify_all();
+    }
+    if (runtime->mainAssets) {
+        freeFlowMetadataIndex(runtime->mainAssets);
+        freeAssetsNameIndex(runtime->mainAssets);
+        runtime->mainAssets = nullptr;
+    }
+    setCurrentRuntime(nullptr);
+    destroyRuntime(runtime);
+}
+static void stopParallelActionWorkers() {
+    if (!g_parallelActionWorkers) {
+        return;
+    }
+    {
+        std::lock_guard<std::mutex> lock(g_parallelActionMutex);
+        g_parallelActionWorkersStopping = true;
+    }
+    g_parallelActionAvailable.notify_all();
+    for (unsigned i = 0; i < g_numParallelActionWorkers; i++) {
+        g_parallelActionWorkers[i].thread.join();
+    }
+    for (unsigned i = 0; i < g_numParallelActionWorkers; i++) {
+        g_parallelActionWorkers[i].~ParallelActionWorker();
+    }
+    free(g_parallelActionWorkers);
+    g_parallelActionWorkers = nullptr;
+    g_numParallelActionWorkers = 0;
+    g_parallelActionWorkersStopping = false;
+}
+void setParallelActionWorkers(unsigned numWorkers) {
+    if (numWorkers == g_numParallelActionWorkers) {
+        return;
+    }
+    stopParallelActionWorkers();
+    if (numWorkers == 0) {
+        return;
+    }
+    g_parallelActionWorkers = (ParallelActionWorker *)alloc(numWorkers * sizeof(ParallelActionWorker), 0x7d3e2a54);
+    if (!g_parallelActionWorkers) {
+        return;
+    }
+    for (unsigned i = 0; i < numWorkers; i++) {
+        new (g_parallelActionWorkers + i) ParallelActionWorker();
+        g_parallelActionWorkers[i].jobs.first = nullptr;
+        g_parallelActionWorkers[i].jobs.last = nullptr;
+    }
+    g_numParallelActionWorkers = numWorkers;
+    for (unsigned i = 0; i < numWorkers; i++) {
+        g_parallelActionWorkers[i].thread = std::thread(parallelActionWorkerMain, i);
+    }
+}
+unsigned getParallelActionWorkers() {
+    return g_numParallelActionWorkers;
+}
+bool dispatchParallelAction(FlowState *flowState, unsigned componentIndex, int flowIndex) {
+    auto runtime = g_runtime;
+    if (
+        g_numParallelActionWorkers == 0 ||
+        runtime->isParallelActionWorker ||
+        runtime->traceMode != TRACE_MODE_OFF ||
+        runtime->debuggerIsConnected ||
+        flowState->assets != runtime->mainAssets
+    ) {
+        return false;
+    }
+    auto info = getParallelActionInfo(flowState->assets, flowIndex);
+    if (!info || info->state != PARALLEL_ACTION_STATE_ELIGIBLE) {
+        return false;
+    }
+    auto flowDefinition = flowState->flowDefinition;
+    auto component = flowState->flow->components[componentIndex];
+    for (uint32_t i = 0; i < component->inputs.count; i++) {
+        if (!canDetachValue(flowState->values[component->inputs[i]])) {
+            return false;
+        }
+    }
+    for (unsigned i = 0; i < info->numGlobals; i++) {
+        if (!canDetachValue(*getGlobalVariablePtr(flowDefinition, info->globals[i]))) {
+            return false;
+        }
+    }
+    auto numInputs = component->inputs.count;
+    auto numUserProperties = component->properties.count;
+    auto job = (ParallelActionJob *)alloc(sizeof(ParallelActionJob) + (numInputs + numUserProperties) * sizeof(Value), 0x7d3e2a55);
+    if (!job) {
+        return false;
+    }
+    job->owner = runtime;
+    job->assets = flowState->assets;
+    job->flowState = flowState;
+    job->parentFlowIndex = flowState->flowIndex;
+    job->componentIndex = componentIndex;
+    job->flowIndex = flowIndex;
+    job->numInputs = numInputs;
+    job->inputs = (Value *)(job + 1);
+    job->numUserProperties = numUserProperties;
+    job->userProperties = job->inputs + numInputs;
+    job->globalVariables = nullptr;
+    job->firstEvent = nullptr;
+    job->lastEvent = nullptr;
+    for (unsigned i = 0; i < numInputs + numUserProperties; i++) {
+        new (job->inputs + i) Value();
+    }
+    for (unsigned i = 0; i < numUserProperties; i++) {
+        Value value;
+        char errorMessage[64];
+        snprintf(errorMessage, sizeof(errorMessage), "Failed to evaluate property #%d in CallAction", (int)(i + 1));
+        if (!evalProperty(flowState, componentIndex, i, value, errorMessage)) {
+            break;
+        }
+        if (!canDetachValue(value)) {
+            freeParallelActionJob(job);
+            return false;
+        }
+        job->userProperties[i] = value.clone();
+    }
+    auto numGlobalVariables = flowDefinition->globalVariables.count;
+    job->globalVariables = (GlobalVariables *)alloc(
+        sizeof(GlobalVariables) +
+        (numGlobalVariables > 0 ? numGlobalVariables - 1 : 0) * sizeof(Value),
+        0x7d3e2a56
+    );
+    if (!job->globalVariables) {
+        freeParallelActionJob(job);
+        return false;
+    }
+    job->globalVariables->count = numGlobalVariables;
+    for (uint32_t i = 0; i < numGlobalVariables; i++) {
+        new (job->globalVariables->values + i) Value();
+    }
+    for (unsigned i = 0; i < info->numGlobals; i++) {
+        auto globalVariableIndex = info->globals[i];
+        job->globalVariables->values[globalVariableIndex] = getGlobalVariablePtr(flowDefinition, globalVariableIndex)->clone();
+    }
+    for (unsigned i = 0; i < numInputs; i++) {
+        job->inputs[i] = flowState->values[component->inputs[i]].clone();
+    }
+    incRefCounterForFlowState(flowState);
+    runtime->numParallelActionsInFlight++;
+    auto &worker = g_parallelActionWorkers[g_nextParallelActionWorker++ % g_numParallelActionWorkers];
+    {
+        std::lock_guard<std::mutex> lock(worker.mutex);
+        appendParallelActionJob(worker.jobs, job);
+    }
+    {
+        std::lock_guard<std::mutex> lock(g_parallelActionMutex);
+        g_numQueuedParallelActions++;
+    }
+    g_parallelActionAvailable.notify_one();
+    return true;
+}
+static void addParallelActionEvent(ParallelActionJob *job, int outputIndex, bool isError, const Value &value) {
+    auto event = (ParallelActionEvent *)alloc(sizeof(ParallelActionEvent), 0x7d3e2a57);
+    if (!event) {
+        return;
+    }
+    new (event) ParallelActionEvent();
+    event->next = nullptr;
+    event->outputIndex = outputIndex;
+    event->isError = isError;
+    event->value = Value(value).clone();
+    if (job->lastEvent) {
+        job->lastEvent->next = event;
+    } else {
+        job->firstEvent = event;
+    }
+    job->lastEvent = event;
+}
+void onParallelActionOutput(FlowState *flowState, unsigned outputIndex, const Value &value) {
+    addParallelActionEvent(flowState->parallelActionJob, outputIndex, false, value.getValue());
+}
+bool onParallelActionError(FlowState *flowState, const char *errorMessage) {
+    for (auto fs = flowState; fs; fs = fs->parentFlowState) {
+        if (fs->parallelActionJob) {
+            addParallelActionEvent(fs->parallelActionJob, -1, true, Value::makeStringRef(errorMessage, strlen(errorMessage), 0x7d3e2a58));
+            for (auto errorFlowState = flowState; errorFlowState != fs; errorFlowState = errorFlowState->parentFlowState) {
+                errorFlowState->error = true;
+            }
+            return true;
+        }
+    }
+    return false;
+}
+static void completeParallelActionJob(ParallelActionJob *job) {
+    auto flowState = job->flowState;
+    for (auto event = job->firstEvent; event; event = event->next) {
+        if (event->isError) {
+            throwError(flowState, job->componentIndex, event->value.getString());
+        } else {
+            propagateValue(flowState, job->componentIndex, event->outputIndex, event->value);
+        }
+    }
+    freeParallelActionJob(job);
+    decRefCounterForFlowState(flowState);
+    do {
+        if (!canFreeFlowState(flowState)) {
+            break;
+        }
+        auto temp = flowState->parentFlowState;
+        freeFlowState(flowState);
+        flowState = temp;
+    } while (flowState);
+}
+static void takeDoneParallelActionJobs(Runtime *runtime, ParallelActionJobList &jobs) {
+    for (auto job = g_doneParallelActions.first; job; ) {
+        auto nextJob = job->next;
+        if (job->owner == runtime) {
+            removeParallelActionJob(g_doneParallelActions, job);
+            appendParallelActionJob(jobs, job);
+        }
+        job = nextJob;
+    }
+}
+void visitParallelActions() {
+    auto runtime = g_runtime;
+    if (runtime->numParallelActionsInFlight == 0) {
+        return;
+    }
+    ParallelActionJobList jobs = { nullptr, nullptr };
+    {
+        std::lock_guard<std::mutex> lock(g_parallelActionMutex);
+        takeDoneParallelActionJobs(runtime, jobs);
+    }
+    for (auto job = jobs.first; job; ) {
+        auto nextJob = job->next;
+        runtime->numParallelActionsInFlight--;
+        completeParallelActionJob(job);
+        if (isFlowStopped() || runtime->isStopping) {
+            for (job = nextJob; job; job = nextJob) {
+                nextJob = job->next;
+                runtime->numParallelActionsInFlight--;
+                freeParallelActionJob(job);
+            }
+            break;
+        }
+        job = nextJob;
+    }
+}
+void cancelParallelActions() {
+    auto runtime = g_runtime;
+    if (runtime->numParallelActionsInFlight > 0) {
+        ParallelActionJobList jobs = { nullptr, nullptr };
+        {
+            std::unique_lock<std::mutex> lock(g_parallelActionMutex);
+            while (true) {
+                takeDoneParallelActionJobs(runtime, jobs);
+                for (auto job = jobs.first; job; job = job->next) {
+                    runtime->numParallelActionsInFlight--;
+                }
+                for (auto job = jobs.first; job; ) {
+                    auto nextJob = job->next;
+                    freeParallelActionJob(job);
+                    job = nextJob;
+                }
+                jobs.first = jobs.last = nullptr;
+                if (runtime->numParallelActionsInFlight == 0) {
+                    break;
+                }
+                g_parallelActionDone.wait(lock);
+            }
+        }
+    }
+    freeParallelActionInfos();
+}
+#endif
 } 
 } 
 // -----------------------------------------------------------------------------
@@ -9169,9 +12121,7 @@ using namespace eez::gui;
 #endif
 namespace eez {
 namespace flow {
-GlobalVariables *g_globalVariables = nullptr;
 static const unsigned NO_COMPONENT_INDEX = 0xFFFFFFFF;
-static bool g_enableThrowError = true;
 inline bool isInputEmpty(const Value& inputValue) {
     return inputValue.type == VALUE_TYPE_UNDEFINED && inputValue.int32Value > 0;
 }
@@ -9181,28 +12131,237 @@ inline Value getEmptyInputValue() {
     return emptyInputValue;
 }
 void initGlobalVariables(Assets *assets) {
-    if (!g_mainAssetsUncompressed) {
+    if (!g_runtime->mainAssetsUncompressed) {
         return;
     }
 	auto flowDefinition = static_cast<FlowDefinition *>(assets->flowDefinition);
     auto numVars = flowDefinition->globalVariables.count;
-    g_globalVariables = (GlobalVariables *) alloc(
+    g_runtime->globalVariables = (GlobalVariables *) alloc(
         sizeof(GlobalVariables) +
         (numVars > 0 ? numVars - 1 : 0) * sizeof(Value),
         0xcc34ca8e
     );
+    g_runtime->globalVariables->count = numVars;
     for (uint32_t i = 0; i < numVars; i++) {
-		new (g_globalVariables->values + i) Value();
-        g_globalVariables->values[i] = flowDefinition->globalVariables[i]->clone();
+		new (g_runtime->globalVariables->values + i) Value();
+        g_runtime->globalVariables->values[i] = flowDefinition->globalVariables[i]->clone();
 	}
 }
-bool isComponentReadyToRun(FlowState *flowState, unsigned componentIndex) {
-	auto component = flowState->flow->components[componentIndex];
-	if (component->type == defs_v3::COMPONENT_TYPE_CATCH_ERROR_ACTION) {
+static bool isComponentReadyAtStart(Component *component, const ComponentMetadata &componentMetadata) {
+	if (
+        component->type == defs_v3::COMPONENT_TYPE_CATCH_ERROR_ACTION ||
+        component->type == defs_v3::COMPONENT_TYPE_ON_EVENT_ACTION ||
+        component->type == defs_v3::COMPONENT_TYPE_LABEL_IN_ACTION
+    ) {
 		return false;
 	}
-    if (component->type == defs_v3::COMPONENT_TYPE_ON_EVENT_ACTION) {
-        return false;
+    if ((component->type < defs_v3::COMPONENT_TYPE_START_ACTION && component->type != defs_v3::COMPONENT_TYPE_USER_WIDGET_WIDGET) || component->type >= defs_v3::FIRST_DASHBOARD_WIDGET_COMPONENT_TYPE) {
+        return true;
+    }
+    if (component->type == defs_v3::COMPONENT_TYPE_START_ACTION) {
+        return true;
+    }
+    return componentMetadata.numMandatoryInputs == 0 && componentMetadata.numSeqInputs == 0;
+}
+static bool isInlineActionComponentType(uint16_t componentType) {
+    switch (componentType) {
+    case defs_v3::COMPONENT_TYPE_START_ACTION:
+    case defs_v3::COMPONENT_TYPE_END_ACTION:
+    case defs_v3::COMPONENT_TYPE_INPUT_ACTION:
+    case defs_v3::COMPONENT_TYPE_OUTPUT_ACTION:
+    case defs_v3::COMPONENT_TYPE_EVAL_EXPR_ACTION:
+    case defs_v3::COMPONENT_TYPE_SET_VARIABLE_ACTION:
+    case defs_v3::COMPONENT_TYPE_CONSTANT_ACTION:
+    case defs_v3::COMPONENT_TYPE_COMPARE_ACTION:
+    case defs_v3::COMPONENT_TYPE_IS_TRUE_ACTION:
+    case defs_v3::COMPONENT_TYPE_SWITCH_ACTION:
+    case defs_v3::COMPONENT_TYPE_NOOP_ACTION:
+    case defs_v3::COMPONENT_TYPE_COMMENT_ACTION:
+        return true;
+    default:
+        return false;
+    }
+}
+static bool hasConnectionCycle(Flow *flow, unsigned componentIndex, uint8_t *visitState) {
+    visitState[componentIndex] = 1;
+    auto component = flow->components[componentIndex];
+    for (unsigned outputIndex = 0; outputIndex < component->outputs.count; outputIndex++) {
+        auto &connections = component->outputs[outputIndex]->connections;
+        for (unsigned connectionIndex = 0; connectionIndex < connections.count; connectionIndex++) {
+            auto targetComponentIndex = connections[connectionIndex]->targetComponentIndex;
+            if (targetComponentIndex >= flow->components.count) {
+                return true;
+            }
+            if (visitState[targetComponentIndex] == 1) {
+                return true;
+            }
+            if (visitState[targetComponentIndex] == 0 && hasConnectionCycle(flow, targetComponentIndex, visitState)) {
+                return true;
+            }
+        }
+    }
+    visitState[componentIndex] = 2;
+    return false;
+}
+static bool isInlineActionCandidate(Flow *flow, FlowMetadata *flowMetadata) {
+    auto numComponents = flow->components.count;
+    if (numComponents > EEZ_FLOW_INLINE_ACTION_MAX_TASKS || flowMetadata->numStartReadyComponents != 1) {
+        return false;
+    }
+    for (unsigned componentIndex = 0; componentIndex < numComponents; componentIndex++) {
+        auto component = flow->components[componentIndex];
+        if (!isInlineActionComponentType(component->type) || component->breakpoint == BREAKPOINT_ENABLED) {
+            return false;
+        }
+    }
+    uint8_t visitState[EEZ_FLOW_INLINE_ACTION_MAX_TASKS] = {};
+    for (unsigned componentIndex = 0; componentIndex < numComponents; componentIndex++) {
+        if (visitState[componentIndex] == 0 && hasConnectionCycle(flow, componentIndex, visitState)) {
+            return false;
+        }
+    }
+    return true;
+}
+static FlowMetadata *buildFlowMetadata(Flow *flow) {
+    auto numInputs = flow->componentInputs.count;
+    auto numComponents = flow->components.count;
+    auto flowMetadata = (FlowMetadata *)alloc(
+        sizeof(FlowMetadata) +
+        numComponents * sizeof(ComponentMetadata) +
+        numInputs * sizeof(InputMetadata) +
+        numComponents * sizeof(uint16_t),
+        0x3a9d51e7
+    );
+    if (!flowMetadata) {
+        return nullptr;
+    }
+    flowMetadata->components = (ComponentMetadata *)(flowMetadata + 1);
+    flowMetadata->inputs = (InputMetadata *)(flowMetadata->components + numComponents);
+    flowMetadata->startReadyComponents = (uint16_t *)(flowMetadata->inputs + numInputs);
+    flowMetadata->numStartReadyComponents = 0;
+    flowMetadata->numPooledFlowStates = 0;
+    flowMetadata->pooledFlowStates = nullptr;
+    for (unsigned i = 0; i < numInputs; i++) {
+        flowMetadata->inputs[i].componentIndex = 0;
+        flowMetadata->inputs[i].flags = 0;
+    }
+    for (unsigned componentIndex = 0; componentIndex < numComponents; componentIndex++) {
+        auto component = flow->components[componentIndex];
+        auto &componentMetadata = flowMetadata->components[componentIndex];
+        componentMetadata.seqOutIndex = -1;
+        componentMetadata.numMandatoryInputs = 0;
+        componentMetadata.numSeqInputs = 0;
+        componentMetadata.fanOut = 0;
+        for (unsigned inputIndex = 0; inputIndex < component->inputs.count; inputIndex++) {
+            auto inputValueIndex = component->inputs[inputIndex];
+            auto input = flow->componentInputs[inputValueIndex];
+            auto &inputMetadata = flowMetadata->inputs[inputValueIndex];
+            inputMetadata.componentIndex = componentIndex;
+            if (input & COMPONENT_INPUT_FLAG_IS_SEQ_INPUT) {
+                inputMetadata.flags = INPUT_METADATA_FLAG_SEQ;
+                componentMetadata.numSeqInputs++;
+            } else if (!(input & COMPONENT_INPUT_FLAG_IS_OPTIONAL)) {
+                inputMetadata.flags = INPUT_METADATA_FLAG_MANDATORY;
+                componentMetadata.numMandatoryInputs++;
+            }
+        }
+        for (unsigned outputIndex = 0; outputIndex < component->outputs.count; outputIndex++) {
+            auto componentOutput = component->outputs[outputIndex];
+            if (componentOutput->isSeqOut && componentMetadata.seqOutIndex == -1) {
+                componentMetadata.seqOutIndex = outputIndex;
+            }
+            componentMetadata.fanOut += componentOutput->connections.count;
+        }
+        if (isComponentReadyAtStart(component, componentMetadata)) {
+            flowMetadata->startReadyComponents[flowMetadata->numStartReadyComponents++] = componentIndex;
+        }
+    }
+    flowMetadata->isInlineAction = isInlineActionCandidate(flow, flowMetadata);
+    return flowMetadata;
+}
+static void freeFlowMetadataIndex(FlowMetadataIndex &index) {
+    for (unsigned i = 0; i < index.numFlows; i++) {
+        if (index.flows[i]) {
+            while (index.flows[i]->pooledFlowStates) {
+                auto pooledFlowState = index.flows[i]->pooledFlowStates;
+                index.flows[i]->pooledFlowStates = *(void **)pooledFlowState;
+                free(pooledFlowState);
+            }
+            free(index.flows[i]);
+        }
+    }
+    if (index.flows) {
+        free(index.flows);
+    }
+    index.assets = nullptr;
+    index.flows = nullptr;
+    index.numFlows = 0;
+}
+static bool buildFlowMetadataIndex(FlowMetadataIndex &index, Assets *assets) {
+    freeFlowMetadataIndex(index);
+    auto flowDefinition = static_cast<FlowDefinition *>(assets->flowDefinition);
+    if (!flowDefinition || flowDefinition->flows.count == 0) {
+        return false;
+    }
+    auto numFlows = flowDefinition->flows.count;
+    index.flows = (FlowMetadata **)alloc(numFlows * sizeof(FlowMetadata *), 0x3a9d51e8);
+    if (!index.flows) {
+        return false;
+    }
+    index.assets = assets;
+    index.numFlows = numFlows;
+    for (unsigned flowIndex = 0; flowIndex < numFlows; flowIndex++) {
+        index.flows[flowIndex] = buildFlowMetadata(flowDefinition->flows[flowIndex]);
+    }
+    return true;
+}
+void buildFlowMetadataIndex(Assets *assets) {
+    buildFlowMetadataIndex(assets == g_runtime->mainAssets ? g_runtime->mainFlowMetadataIndex : g_runtime->externalFlowMetadataIndex, assets);
+}
+void freeFlowMetadataIndex(Assets *assets) {
+    if (g_runtime->mainFlowMetadataIndex.assets == assets) {
+        freeFlowMetadataIndex(g_runtime->mainFlowMetadataIndex);
+    }
+    if (g_runtime->externalFlowMetadataIndex.assets == assets) {
+        freeFlowMetadataIndex(g_runtime->externalFlowMetadataIndex);
+    }
+}
+FlowMetadata *getFlowMetadata(Assets *assets, int flowIndex) {
+    auto &index = assets == g_runtime->mainAssets ? g_runtime->mainFlowMetadataIndex : g_runtime->externalFlowMetadataIndex;
+    if (index.assets != assets) {
+        if (!buildFlowMetadataIndex(index, assets)) {
+            return nullptr;
+        }
+    }
+    if ((unsigned)flowIndex >= index.numFlows) {
+        return nullptr;
+    }
+    return index.flows[flowIndex];
+}
+static inline void onInputEmptyStateChanged(FlowState *flowState, unsigned inputValueIndex, bool isEmpty) {
+    auto &inputMetadata = flowState->flowMetadata->inputs[inputValueIndex];
+    auto &counters = flowState->componentInputCounters[inputMetadata.componentIndex];
+    if (inputMetadata.flags & INPUT_METADATA_FLAG_SEQ) {
+        if (isEmpty) {
+            counters.numNonEmptySeqInputs--;
+        } else {
+            counters.numNonEmptySeqInputs++;
+        }
+    } else if (inputMetadata.flags & INPUT_METADATA_FLAG_MANDATORY) {
+        if (isEmpty) {
+            counters.numEmptyMandatoryInputs++;
+        } else {
+            counters.numEmptyMandatoryInputs--;
+        }
+    }
+}
+bool isComponentReadyToRun(FlowState *flowState, unsigned componentIndex) {
+	auto component = flowState->flow->components[componentIndex];
+	if (component->type == defs_v3::COMPONENT_TYPE_CATCH_ERROR_ACTION) {
+		return false;
+	}
+    if (component->type == defs_v3::COMPONENT_TYPE_ON_EVENT_ACTION) {
+        return false;
     }
     if (component->type == defs_v3::COMPONENT_TYPE_LABEL_IN_ACTION) {
         return false;
@@ -9219,27 +12378,11 @@ bool isComponentReadyToRun(FlowState *flowState, unsigned componentIndex) {
             return true;
         }
     }
-	int numSeqInputs = 0;
-	int numDefinedSeqInputs = 0;
-	for (unsigned inputIndex = 0; inputIndex < component->inputs.count; inputIndex++) {
-		auto inputValueIndex = component->inputs[inputIndex];
-		auto input = flowState->flow->componentInputs[inputValueIndex];
-		if (input & COMPONENT_INPUT_FLAG_IS_SEQ_INPUT) {
-			numSeqInputs++;
-			auto &value = flowState->values[inputValueIndex];
-			if (!isInputEmpty(value)) {
-				numDefinedSeqInputs++;
-			}
-		} else {
-			if (!(input & COMPONENT_INPUT_FLAG_IS_OPTIONAL)) {
-				auto &value = flowState->values[inputValueIndex];
-				if (isInputEmpty(value)) {
-					return false;
-				}
-			}
-		}
-	}
-	if (numSeqInputs && !numDefinedSeqInputs) {
+    auto &counters = flowState->componentInputCounters[componentIndex];
+    if (counters.numEmptyMandatoryInputs > 0) {
+        return false;
+    }
+	if (flowState->flowMetadata->components[componentIndex].numSeqInputs > 0 && counters.numNonEmptySeqInputs == 0) {
 		return false;
 	}
 	return true;
@@ -9250,31 +12393,48 @@ static bool pingComponent(FlowState *flowState, unsigned componentIndex, int sou
 	}
 	return false;
 }
-static FlowState *initFlowState(Assets *assets, int flowIndex, FlowState *parentFlowState, int parentComponentIndex, const Value& inputValue) {
+FlowState *initFlowState(Assets *assets, int flowIndex, FlowState *parentFlowState, int parentComponentIndex, const Value& inputValue, bool pingStartComponents) {
 	auto flowDefinition = static_cast<FlowDefinition *>(assets->flowDefinition);
 	auto flow = flowDefinition->flows[flowIndex];
+    auto flowMetadata = getFlowMetadata(assets, flowIndex);
+    if (!flowMetadata) {
+        return nullptr;
+    }
 	auto nValues = flow->componentInputs.count + flow->localVariables.count;
-	FlowState *flowState = new (
-		alloc(
+	void *flowStateBlock = flowMetadata->pooledFlowStates;
+	if (flowStateBlock) {
+		flowMetadata->pooledFlowStates = *(void **)flowStateBlock;
+		flowMetadata->numPooledFlowStates--;
+	} else {
+		flowStateBlock = alloc(
 			sizeof(FlowState) +
 			nValues * sizeof(Value) +
 			flow->components.count * sizeof(ComponenentExecutionState *) +
+			flow->components.count * sizeof(uint32_t) +
+			flow->components.count * sizeof(ComponentInputCounters) +
 			flow->components.count * sizeof(bool),
 			0x4c3b6ef5
-		)
-	) FlowState;
+		);
+	}
+	FlowState *flowState = new (flowStateBlock) FlowState;
 	flowState->flowStateIndex = (int)((uint8_t *)flowState - ALLOC_BUFFER);
+	flowState->traceId = ++g_runtime->numTracedFlowStates;
 	flowState->assets = assets;
 	flowState->flowDefinition = static_cast<FlowDefinition *>(assets->flowDefinition);
 	flowState->flow = flowDefinition->flows[flowIndex];
+    flowState->flowMetadata = flowMetadata;
 	flowState->flowIndex = flowIndex;
 	flowState->error = false;
 	flowState->refCounter = 0;
+	flowState->numBusyChildren = 0;
 	flowState->parentFlowState = parentFlowState;
     flowState->executingComponentIndex = NO_COMPONENT_INDEX;
     flowState->timelinePosition = 0;
 #if defined(EEZ_FOR_LVGL)
     flowState->lvglWidgetStartIndex = 0;
+#endif
+#if EEZ_FLOW_PARALLEL_ACTIONS
+    flowState->parallelActionJob = nullptr;
 #endif
     if (parentFlowState) {
         if (parentFlowState->lastChild) {
@@ -9289,14 +12449,14 @@ static FlowState *initFlowState(Assets *assets, int flowIndex, FlowState *parent
 		flowState->parentComponentIndex = parentComponentIndex;
 		flowState->parentComponent = parentComponentIndex == -1 ? nullptr : parentFlowState->flow->components[parentComponentIndex];
 	} else {
-        if (g_lastFlowState) {
-            g_lastFlowState->nextSibling = flowState;
-            flowState->previousSibling = g_lastFlowState;
-            g_lastFlowState = flowState;
+        if (g_runtime->lastFlowState) {
+            g_runtime->lastFlowState->nextSibling = flowState;
+            flowState->previousSibling = g_runtime->lastFlowState;
+            g_runtime->lastFlowState = flowState;
         } else {
             flowState->previousSibling = nullptr;
-            g_firstFlowState = flowState;
-            g_lastFlowState = flowState;
+            g_runtime->firstFlowState = flowState;
+            g_runtime->lastFlowState = flowState;
         }
 		flowState->parentComponentIndex = -1;
 		flowState->parentComponent = nullptr;
@@ -9307,7 +12467,9 @@ static FlowState *initFlowState(Assets *assets, int flowIndex, FlowState *parent
     flowState->nextSibling = nullptr;
 	flowState->values = (Value *)(flowState + 1);
 	flowState->componenentExecutionStates = (ComponenentExecutionState **)(flowState->values + nValues);
-    flowState->componenentAsyncStates = (bool *)(flowState->componenentExecutionStates + flow->components.count);
+    flowState->componentQueueCounts = (uint32_t *)(flowState->componenentExecutionStates + flow->components.count);
+    flowState->componentInputCounters = (ComponentInputCounters *)(flowState->componentQueueCounts + flow->components.count);
+    flowState->componenentAsyncStates = (bool *)(flowState->componentInputCounters + flow->components.count);
 	for (unsigned i = 0; i < nValues; i++) {
 		new (flowState->values + i) Value();
 	}
@@ -9321,45 +12483,114 @@ static FlowState *initFlowState(Assets *assets, int flowIndex, FlowState *parent
 	}
 	for (unsigned i = 0; i < flow->components.count; i++) {
 		flowState->componenentExecutionStates[i] = nullptr;
+		flowState->componentQueueCounts[i] = 0;
+		flowState->componentInputCounters[i].numEmptyMandatoryInputs = flowMetadata->components[i].numMandatoryInputs;
+		flowState->componentInputCounters[i].numNonEmptySeqInputs = 0;
 		flowState->componenentAsyncStates[i] = false;
 	}
 	onFlowStateCreated(flowState);
-	for (unsigned componentIndex = 0; componentIndex < flow->components.count; componentIndex++) {
-		pingComponent(flowState, componentIndex);
-	}
+    if (pingStartComponents) {
+        for (unsigned i = 0; i < flowMetadata->numStartReadyComponents; i++) {
+            pingComponent(flowState, flowMetadata->startReadyComponents[i]);
+        }
+    }
 	return flowState;
 }
-FlowState *initActionFlowState(int flowIndex, FlowState *parentFlowState, int parentComponentIndex, const Value &inputValue) {
-	auto flowState = initFlowState(parentFlowState->assets, flowIndex, parentFlowState, parentComponentIndex, inputValue);
+FlowState *initActionFlowState(int flowIndex, FlowState *parentFlowState, int parentComponentIndex, const Value &inputValue, bool pingStartComponents) {
+	auto flowState = initFlowState(parentFlowState->assets, flowIndex, parentFlowState, parentComponentIndex, inputValue, pingStartComponents);
 	if (flowState) {
 		flowState->isAction = true;
 	}
 	return flowState;
 }
+bool isInlineActionFlow(Assets *assets, int flowIndex) {
+    auto flowMetadata = getFlowMetadata(assets, flowIndex);
+    return flowMetadata && flowMetadata->isInlineAction;
+}
+void executeInlineActionFlowState(FlowState *flowState) {
+    auto runtime = g_runtime;
+    InlineActionQueue inlineActionQueue;
+    inlineActionQueue.flowState = flowState;
+    inlineActionQueue.head = 0;
+    inlineActionQueue.tail = 0;
+    auto savedInlineActionQueue = runtime->inlineActionQueue;
+    runtime->inlineActionQueue = &inlineActionQueue;
+    auto flowMetadata = flowState->flowMetadata;
+    for (unsigned i = 0; i < flowMetadata->numStartReadyComponents; i++) {
+        pingComponent(flowState, flowMetadata->startReadyComponents[i]);
+    }
+    while (inlineActionQueue.head < inlineActionQueue.tail && !isFlowStopped() && !runtime->isStopping) {
+        auto componentIndex = inlineActionQueue.componentIndexes[inlineActionQueue.head++];
+        flowState->componentQueueCounts[componentIndex]--;
+        decRefCounterForFlowState(flowState);
+        flowState->executingComponentIndex = componentIndex;
+        if (flowState->error) {
+            deallocateComponentExecutionState(flowState, componentIndex);
+        } else {
+            executeComponent(flowState, componentIndex);
+        }
+        resetSequenceInputs(flowState);
+    }
+    runtime->inlineActionQueue = savedInlineActionQueue;
+    if (inlineActionQueue.head < inlineActionQueue.tail) {
+        while (inlineActionQueue.head < inlineActionQueue.tail) {
+            auto componentIndex = inlineActionQueue.componentIndexes[inlineActionQueue.head++];
+            flowState->componentQueueCounts[componentIndex]--;
+            decRefCounterForFlowState(flowState);
+        }
+        return;
+    }
+    if (canFreeFlowState(flowState)) {
+        freeFlowState(flowState);
+    }
+}
 FlowState *initPageFlowState(Assets *assets, int flowIndex, FlowState *parentFlowState, int parentComponentIndex) {
+    if (!parentFlowState && isTracingExternalCall()) {
+        recordTracePage(assets, flowIndex);
+        TraceEngineScope traceEngineScope(true);
+        return initPageFlowState(assets, flowIndex, parentFlowState, parentComponentIndex);
+    }
 	auto flowState = initFlowState(assets, flowIndex, parentFlowState, parentComponentIndex, Value());
 	if (flowState) {
 		flowState->isAction = false;
 	}
 	return flowState;
 }
+#if EEZ_FLOW_PARALLEL_ACTIONS
+FlowState *initParallelActionProxyFlowState(Assets *assets, int flowIndex, ParallelActionJob *job) {
+	auto flowState = initFlowState(assets, flowIndex, nullptr, -1, Value(), false);
+	if (flowState) {
+		flowState->isAction = false;
+        flowState->parallelActionJob = job;
+	}
+	return flowState;
+}
+#endif
 void incRefCounterForFlowState(FlowState *flowState) {
-    flowState->refCounter++;
+    if (flowState->refCounter++ > 0 || flowState->numBusyChildren > 0) {
+        return;
+    }
     for (auto parent = flowState->parentFlowState; parent; parent = parent->parentFlowState) {
-        parent->refCounter++;
+        if (parent->numBusyChildren++ > 0 || parent->refCounter > 0) {
+            return;
+        }
     }
 }
 void decRefCounterForFlowState(FlowState *flowState) {
-    flowState->refCounter--;
+    if (--flowState->refCounter > 0 || flowState->numBusyChildren > 0) {
+        return;
+    }
     for (auto parent = flowState->parentFlowState; parent; parent = parent->parentFlowState) {
-        parent->refCounter--;
+        if (--parent->numBusyChildren > 0 || parent->refCounter > 0) {
+            return;
+        }
     }
 }
 bool canFreeFlowState(FlowState *flowState) {
     if (!flowState->isAction) {
         return false;
     }
-    if (flowState->refCounter > 0) {
+    if (flowState->refCounter > 0 || flowState->numBusyChildren > 0) {
         return false;
     }
     return true;
@@ -9381,11 +12612,11 @@ void freeFlowState(FlowState *flowState) {
             parentFlowState->lastChild = flowState->previousSibling;
         }
     } else {
-        if (g_firstFlowState == flowState) {
-            g_firstFlowState = flowState->nextSibling;
+        if (g_runtime->firstFlowState == flowState) {
+            g_runtime->firstFlowState = flowState->nextSibling;
         }
-        if (g_lastFlowState == flowState) {
-            g_lastFlowState = flowState->previousSibling;
+        if (g_runtime->lastFlowState == flowState) {
+            g_runtime->lastFlowState = flowState->previousSibling;
         }
     }
     if (flowState->previousSibling) {
@@ -9404,8 +12635,15 @@ void freeFlowState(FlowState *flowState) {
 	}
     freeAllChildrenFlowStates(flowState->firstChild);
 	onFlowStateDestroyed(flowState);
+	auto flowMetadata = flowState->flowMetadata;
 	flowState->~FlowState();
-	free(flowState);
+	if (flowMetadata->numPooledFlowStates < EEZ_FLOW_STATE_POOL_SIZE) {
+		*(void **)flowState = flowMetadata->pooledFlowStates;
+		flowMetadata->pooledFlowStates = flowState;
+		flowMetadata->numPooledFlowStates++;
+	} else {
+		free(flowState);
+	}
 }
 void freeAllChildrenFlowStates(FlowState *firstChildFlowState) {
     auto flowState = firstChildFlowState;
@@ -9435,10 +12673,11 @@ void resetSequenceInputs(FlowState *flowState) {
         if (component->type != defs_v3::COMPONENT_TYPE_OUTPUT_ACTION) {
             for (uint32_t i = 0; i < component->inputs.count; i++) {
                 auto inputIndex = component->inputs[i];
-                if (flowState->flow->componentInputs[inputIndex] & COMPONENT_INPUT_FLAG_IS_SEQ_INPUT) {
+                if (flowState->flowMetadata->inputs[inputIndex].flags & INPUT_METADATA_FLAG_SEQ) {
                     auto pValue = &flowState->values[inputIndex];
                     if (!isInputEmpty(*pValue)) {
                         *pValue = getEmptyInputValue();
+                        onInputEmptyStateChanged(flowState, inputIndex, true);
                         onValueChanged(pValue);
                     }
                 }
@@ -9447,36 +12686,55 @@ void resetSequenceInputs(FlowState *flowState) {
     }
 }
 void propagateValue(FlowState *flowState, unsigned componentIndex, unsigned outputIndex, const Value &value) {
+    if (isTracingExternalCall()) {
+        recordTracePropagateValue(flowState, componentIndex, outputIndex, value);
+        TraceEngineScope traceEngineScope(true);
+        propagateValue(flowState, componentIndex, outputIndex, value);
+        return;
+    }
     if ((int)componentIndex == -1) {
         auto flowIndex = outputIndex;
         executeCallAction(flowState, -1, flowIndex, value);
         return;
     }
+#if EEZ_FLOW_PARALLEL_ACTIONS
+    if (flowState->parallelActionJob) {
+        onParallelActionOutput(flowState, outputIndex, value);
+        return;
+    }
+#endif
     resetSequenceInputs(flowState);
+    if (flowState->flowMetadata->components[componentIndex].fanOut == 0) {
+        return;
+    }
 	auto component = flowState->flow->components[componentIndex];
 	auto componentOutput = component->outputs[outputIndex];
     auto value2 = value.getValue();
 	for (unsigned connectionIndex = 0; connectionIndex < componentOutput->connections.count; connectionIndex++) {
 		auto connection = componentOutput->connections[connectionIndex];
-		auto pValue = &flowState->values[connection->targetInputIndex];
-		if (*pValue != value2) {
-			*pValue = value2;
-				onValueChanged(pValue);
-		}
+        setInputValue(flowState, connection->targetInputIndex, value2);
 		pingComponent(flowState, connection->targetComponentIndex, componentIndex, outputIndex, connection->targetInputIndex);
 	}
 }
+void setInputValue(FlowState *flowState, unsigned inputIndex, const Value &value) {
+    auto pValue = &flowState->values[inputIndex];
+    if (*pValue != value) {
+        bool wasEmpty = isInputEmpty(*pValue);
+        *pValue = value;
+        if (wasEmpty != isInputEmpty(value)) {
+            onInputEmptyStateChanged(flowState, inputIndex, !wasEmpty);
+        }
+        onValueChanged(pValue);
+    }
+}
 void propagateValue(FlowState *flowState, unsigned componentIndex, unsigned outputIndex) {
 	auto &nullValue = *flowState->flowDefinition->constants[NULL_VALUE_INDEX];
 	propagateValue(flowState, componentIndex, outputIndex, nullValue);
 }
 void propagateValueThroughSeqout(FlowState *flowState, unsigned componentIndex) {
-	auto component = flowState->flow->components[componentIndex];
-	for (uint32_t i = 0; i < component->outputs.count; i++) {
-		if (component->outputs[i]->isSeqOut) {
-			propagateValue(flowState, componentIndex, i);
-			return;
-		}
+	auto seqOutIndex = flowState->flowMetadata->components[componentIndex].seqOutIndex;
+	if (seqOutIndex != -1) {
+		propagateValue(flowState, componentIndex, seqOutIndex);
 	}
 }
 #if EEZ_OPTION_GUI
@@ -9602,6 +12860,9 @@ void assignValue(FlowState *flowState, int componentIndex, Value &dstValue, cons
 	}
 }
 void clearInputValue(FlowState *flowState, int inputIndex) {
+    if (isInputEmpty(flowState->values[inputIndex])) {
+        onInputEmptyStateChanged(flowState, inputIndex, false);
+    }
     flowState->values[inputIndex] = Value();
     onValueChanged(flowState->values + inputIndex);
 }
@@ -9613,7 +12874,7 @@ void startAsyncExecution(FlowState *flowState, int componentIndex) {
     }
 }
 void endAsyncExecution(FlowState *flowState, int componentIndex) {
-    if (!g_firstFlowState) {
+    if (!g_runtime->firstFlowState) {
         return;
     }
     if (flowState->componenentAsyncStates[componentIndex]) {
@@ -9655,6 +12916,11 @@ bool findCatchErrorComponent(FlowState *flowState, FlowState *&catchErrorFlowSta
     if (!flowState) {
         return false;
     }
+#if EEZ_FLOW_PARALLEL_ACTIONS
+    if (flowState->parallelActionJob) {
+        return false;
+    }
+#endif
 	for (unsigned componentIndex = 0; componentIndex < flowState->flow->components.count; componentIndex++) {
 		auto component = flowState->flow->components[componentIndex];
 		if (component->type == defs_v3::COMPONENT_TYPE_CATCH_ERROR_ACTION) {
@@ -9672,7 +12938,7 @@ bool findCatchErrorComponent(FlowState *flowState, FlowState *&catchErrorFlowSta
 }
 void throwError(FlowState *flowState, int componentIndex, const char *errorMessage) {
     auto component = flowState->flow->components[componentIndex];
-    if (!g_enableThrowError) {
+    if (!g_runtime->enableThrowError) {
         return;
     }
 #if defined(__EMSCRIPTEN__)
@@ -9718,6 +12984,11 @@ void throwError(FlowState *flowState, int componentIndex, const char *errorMessa
                 );
             }
 		} else {
+#if EEZ_FLOW_PARALLEL_ACTIONS
+            if (onParallelActionError(flowState, errorMessage)) {
+                return;
+            }
+#endif
 			onFlowError(flowState, componentIndex, errorMessage);
 			stopScriptHook();
 		}
@@ -9733,7 +13004,7 @@ void throwError(FlowState *flowState, int componentIndex, const char *errorMessa
     }
 }
 void enableThrowError(bool enable) {
-    g_enableThrowError = enable;
+    g_runtime->enableThrowError = enable;
 }
 } 
 } 
@@ -9742,99 +13013,1000 @@ void enableThrowError(bool enable) {
 // -----------------------------------------------------------------------------
 namespace eez {
 namespace flow {
-#if !defined(EEZ_FLOW_QUEUE_SIZE)
-#define EEZ_FLOW_QUEUE_SIZE 1000
-#endif
-static const unsigned QUEUE_SIZE = EEZ_FLOW_QUEUE_SIZE;
-static struct {
-	FlowState *flowState;
-	unsigned componentIndex;
-    bool continuousTask;
-} g_queue[QUEUE_SIZE];
-static unsigned g_queueHead;
-static unsigned g_queueTail;
-static unsigned g_queueMax;
-static bool g_queueIsFull = false;
-unsigned g_numContinuousTaskInQueue;
+static inline bool isStaticChunk(QueueChunk *chunk) {
+    return chunk >= g_runtime->staticChunks && chunk < g_runtime->staticChunks + g_runtime->numStaticChunks;
+}
+static void freeHeapChunk(QueueChunk *chunk) {
+    free(chunk);
+    g_runtime->queueCapacity -= QUEUE_CHUNK_SIZE;
+    g_runtime->queueChunkFrees++;
+}
+static QueueChunk *allocateChunk() {
+    auto runtime = g_runtime;
+    QueueChunk *chunk;
+    if (runtime->freeStaticChunks) {
+        chunk = runtime->freeStaticChunks;
+        runtime->freeStaticChunks = chunk->next;
+    } else if (runtime->spareChunk) {
+        chunk = runtime->spareChunk;
+        runtime->spareChunk = nullptr;
+    } else {
+        chunk = (QueueChunk *)alloc(sizeof(QueueChunk), 0x5e2c7a31);
+        if (!chunk) {
+            return nullptr;
+        }
+        runtime->queueCapacity += QUEUE_CHUNK_SIZE;
+        runtime->queueChunkAllocations++;
+    }
+    chunk->next = nullptr;
+    return chunk;
+}
+static void releaseChunk(QueueChunk *chunk) {
+    auto runtime = g_runtime;
+    if (isStaticChunk(chunk)) {
+        chunk->next = runtime->freeStaticChunks;
+        runtime->freeStaticChunks = chunk;
+    } else if (!runtime->spareChunk) {
+        runtime->spareChunk = chunk;
+    } else {
+        freeHeapChunk(chunk);
+    }
+}
 void queueReset() {
-	g_queueHead = 0;
-	g_queueTail = 0;
-	g_queueMax  = 0;
-	g_queueIsFull = false;
-    g_numContinuousTaskInQueue = 0;
+    for (unsigned laneIndex = 0; laneIndex < QUEUE_NUM_LANES; laneIndex++) {
+        auto &lane = g_runtime->lanes[laneIndex];
+        for (auto chunk = lane.headChunk; chunk; ) {
+            auto nextChunk = chunk->next;
+            if (!isStaticChunk(chunk)) {
+                freeHeapChunk(chunk);
+            }
+            chunk = nextChunk;
+        }
+        lane.headChunk = lane.tailChunk = nullptr;
+        lane.headIndex = lane.tailIndex = 0;
+        lane.size = 0;
+        lane.numNonContinuousTasks = 0;
+        lane.numContinuousVisits = 0;
+    }
+    if (g_runtime->spareChunk) {
+        freeHeapChunk(g_runtime->spareChunk);
+        g_runtime->spareChunk = nullptr;
+    }
+    g_runtime->freeStaticChunks = nullptr;
+    for (unsigned i = g_runtime->numStaticChunks; i > 0; i--) {
+        g_runtime->staticChunks[i - 1].next = g_runtime->freeStaticChunks;
+        g_runtime->freeStaticChunks = &g_runtime->staticChunks[i - 1];
+    }
+    g_runtime->queueSize = 0;
+    g_runtime->queueCapacity = g_runtime->numStaticChunks * QUEUE_CHUNK_SIZE;
+	g_runtime->queueMax  = 0;
+    g_runtime->queueDepthSum = 0;
+    g_runtime->queueDepthSamples = 0;
+    g_runtime->queueOverflowsAvoided = 0;
+    g_runtime->queueChunkAllocations = 0;
+    g_runtime->queueChunkFrees = 0;
+    g_runtime->numContinuousTaskInQueue = 0;
+    g_runtime->currentQueueLane = QUEUE_LANE_NORMAL;
+}
+QueueLaneScope::QueueLaneScope(QueueLane lane) : savedLane(g_runtime->currentQueueLane) {
+    g_runtime->currentQueueLane = lane;
+}
+QueueLaneScope::~QueueLaneScope() {
+    g_runtime->currentQueueLane = savedLane;
 }
 size_t getQueueSize() {
-	if (g_queueHead == g_queueTail) {
-		if (g_queueIsFull) {
-			return QUEUE_SIZE;
-		}
-		return 0;
-	}
-	if (g_queueHead < g_queueTail) {
-		return g_queueTail - g_queueHead;
-	}
-	return QUEUE_SIZE - g_queueHead + g_queueTail;
+	return g_runtime->queueSize;
 }
 size_t getMaxQueueSize() {
-	return g_queueMax;
+	return g_runtime->queueMax;
+}
+void queueSampleDepth() {
+    g_runtime->queueDepthSum += g_runtime->queueSize;
+    g_runtime->queueDepthSamples++;
+}
+void getQueueStats(QueueStats &stats) {
+    stats.size = g_runtime->queueSize;
+    stats.capacity = g_runtime->queueCapacity;
+    stats.highWaterMark = g_runtime->queueMax;
+    stats.averageDepth = g_runtime->queueDepthSamples > 0 ? 1.0f * g_runtime->queueDepthSum / g_runtime->queueDepthSamples : 0.0f;
+    stats.overflowsAvoided = g_runtime->queueOverflowsAvoided;
+    stats.chunkAllocations = g_runtime->queueChunkAllocations;
+    stats.chunkFrees = g_runtime->queueChunkFrees;
+}
+void setFlowQueueLane(unsigned flowIndex, QueueLane lane) {
+    if (flowIndex >= g_runtime->numFlowQueueLanes) {
+        auto numFlowQueueLanes = flowIndex + 1;
+        auto flowQueueLanes = (uint8_t *)alloc(numFlowQueueLanes, 0x6b1f02d4);
+        if (!flowQueueLanes) {
+            return;
+        }
+        for (unsigned i = 0; i < numFlowQueueLanes; i++) {
+            if (i < g_runtime->numFlowQueueLanes) {
+                flowQueueLanes[i] = g_runtime->flowQueueLanes[i];
+            } else {
+                flowQueueLanes[i] = QUEUE_LANE_INHERIT;
+            }
+        }
+        if (g_runtime->flowQueueLanes) {
+            free(g_runtime->flowQueueLanes);
+        }
+        g_runtime->flowQueueLanes = flowQueueLanes;
+        g_runtime->numFlowQueueLanes = numFlowQueueLanes;
+    }
+    g_runtime->flowQueueLanes[flowIndex] = lane;
+}
+static inline unsigned getTaskLane(FlowState *flowState) {
+    if (isDebuggerTrackingQueue()) {
+        return QUEUE_LANE_NORMAL;
+    }
+    if (flowState->flowIndex < g_runtime->numFlowQueueLanes && g_runtime->flowQueueLanes[flowState->flowIndex] != QUEUE_LANE_INHERIT) {
+        return g_runtime->flowQueueLanes[flowState->flowIndex];
+    }
+    return g_runtime->currentQueueLane;
+}
+static inline QueueLaneState *getNextLane() {
+    auto runtime = g_runtime;
+    for (unsigned laneIndex = 0; laneIndex < QUEUE_NUM_LANES; laneIndex++) {
+        auto &lane = runtime->lanes[laneIndex];
+        if (lane.size > 0 && (lane.numNonContinuousTasks > 0 || lane.numContinuousVisits < lane.size)) {
+            return &lane;
+        }
+    }
+    return nullptr;
+}
+void resetQueueLaneVisits() {
+    for (unsigned laneIndex = 0; laneIndex < QUEUE_NUM_LANES; laneIndex++) {
+        g_runtime->lanes[laneIndex].numContinuousVisits = 0;
+    }
 }
 bool addToQueue(FlowState *flowState, unsigned componentIndex, int sourceComponentIndex, int sourceOutputIndex, int targetInputIndex, bool continuousTask) {
-	if (g_queueIsFull) {
-        throwError(flowState, componentIndex, "Execution queue is full\n");
-		return false;
-	}
-	g_queue[g_queueTail].flowState = flowState;
-	g_queue[g_queueTail].componentIndex = componentIndex;
-    g_queue[g_queueTail].continuousTask = continuousTask;
-	g_queueTail = (g_queueTail + 1) % QUEUE_SIZE;
-	if (g_queueHead == g_queueTail) {
-		g_queueIsFull = true;
-	}
-	size_t queueSize = getQueueSize();
-	g_queueMax = g_queueMax < queueSize ? queueSize : g_queueMax;
+    auto runtime = g_runtime;
+    if (runtime->traceMode == TRACE_MODE_RECORD && !runtime->traceInEngine) {
+        recordTraceAddToQueue(flowState, componentIndex, sourceComponentIndex, sourceOutputIndex, targetInputIndex, continuousTask);
+        TraceEngineScope traceEngineScope(true);
+        return addToQueue(flowState, componentIndex, sourceComponentIndex, sourceOutputIndex, targetInputIndex, continuousTask);
+    }
+    auto inlineActionQueue = runtime->inlineActionQueue;
+    if (inlineActionQueue && inlineActionQueue->flowState == flowState && !continuousTask && inlineActionQueue->tail < EEZ_FLOW_INLINE_ACTION_MAX_TASKS) {
+        inlineActionQueue->componentIndexes[inlineActionQueue->tail++] = componentIndex;
+        flowState->componentQueueCounts[componentIndex]++;
+        incRefCounterForFlowState(flowState);
+        return true;
+    }
+    auto &lane = runtime->lanes[getTaskLane(flowState)];
+	if (!lane.tailChunk || lane.tailIndex == QUEUE_CHUNK_SIZE) {
+        auto chunk = allocateChunk();
+        if (!chunk) {
+            throwError(flowState, componentIndex, "Execution queue is full\n");
+            return false;
+        }
+        if (lane.tailChunk) {
+            lane.tailChunk->next = chunk;
+        } else {
+            lane.headChunk = chunk;
+            lane.headIndex = 0;
+        }
+        lane.tailChunk = chunk;
+        lane.tailIndex = 0;
+	}
+    auto &task = lane.tailChunk->tasks[lane.tailIndex++];
+	task.flowState = flowState;
+	task.componentIndex = componentIndex;
+    task.continuousTask = continuousTask;
+    lane.size++;
+    flowState->componentQueueCounts[componentIndex]++;
+    if (runtime->queueSize++ >= QUEUE_SIZE) {
+        runtime->queueOverflowsAvoided++;
+    }
+	runtime->queueMax = runtime->queueMax < runtime->queueSize ? runtime->queueSize : runtime->queueMax;
     if (!continuousTask) {
-        ++g_numContinuousTaskInQueue;
+        lane.numNonContinuousTasks++;
+        ++runtime->numContinuousTaskInQueue;
 	    onAddToQueue(flowState, sourceComponentIndex, sourceOutputIndex, componentIndex, targetInputIndex);
     }
     incRefCounterForFlowState(flowState);
 	return true;
 }
 bool peekNextTaskFromQueue(FlowState *&flowState, unsigned &componentIndex, bool &continuousTask) {
-	if (g_queueHead == g_queueTail && !g_queueIsFull) {
+    auto lane = getNextLane();
+	if (!lane) {
 		return false;
 	}
-	flowState = g_queue[g_queueHead].flowState;
-	componentIndex = g_queue[g_queueHead].componentIndex;
-    continuousTask = g_queue[g_queueHead].continuousTask;
+    auto &task = lane->headChunk->tasks[lane->headIndex];
+	flowState = task.flowState;
+	componentIndex = task.componentIndex;
+    continuousTask = task.continuousTask;
 	return true;
 }
+QueueLane getNextTaskQueueLane() {
+    auto lane = getNextLane();
+    return lane ? (QueueLane)(lane - g_runtime->lanes) : QUEUE_LANE_NORMAL;
+}
 void removeNextTaskFromQueue() {
-	auto flowState = g_queue[g_queueHead].flowState;
+    auto runtime = g_runtime;
+    auto lane = getNextLane();
+    auto &task = lane->headChunk->tasks[lane->headIndex];
+	auto flowState = task.flowState;
+    flowState->componentQueueCounts[task.componentIndex]--;
     decRefCounterForFlowState(flowState);
-    auto continuousTask = g_queue[g_queueHead].continuousTask;
-	g_queueHead = (g_queueHead + 1) % QUEUE_SIZE;
-	g_queueIsFull = false;
+    auto continuousTask = task.continuousTask;
+    if (continuousTask) {
+        lane->numContinuousVisits++;
+    } else {
+        lane->numNonContinuousTasks--;
+    }
+    runtime->queueSize--;
+    if (--lane->size == 0) {
+        releaseChunk(lane->headChunk);
+        lane->headChunk = lane->tailChunk = nullptr;
+        lane->headIndex = lane->tailIndex = 0;
+        lane->numContinuousVisits = 0;
+    } else if (++lane->headIndex == QUEUE_CHUNK_SIZE) {
+        auto chunk = lane->headChunk;
+        lane->headChunk = chunk->next;
+        lane->headIndex = 0;
+        releaseChunk(chunk);
+    }
+    if (runtime->queueSize == 0 && runtime->spareChunk) {
+        freeHeapChunk(runtime->spareChunk);
+        runtime->spareChunk = nullptr;
+    }
     if (!continuousTask) {
-        --g_numContinuousTaskInQueue;
+        --runtime->numContinuousTaskInQueue;
 	    onRemoveFromQueue();
     }
 }
 bool isInQueue(FlowState *flowState, unsigned componentIndex) {
-	if (g_queueHead == g_queueTail && !g_queueIsFull) {
-		return false;
-	}
-    unsigned int it = g_queueHead;
-    while (true) {
-		if (g_queue[it].flowState == flowState && g_queue[it].componentIndex == componentIndex) {
-            return true;
-		}
-        it = (it + 1) % QUEUE_SIZE;
-        if (it == g_queueTail) {
+    return flowState->componentQueueCounts[componentIndex] > 0;
+}
+} 
+} 
+// -----------------------------------------------------------------------------
+// flow/runtime.cpp
+// -----------------------------------------------------------------------------
+namespace eez {
+namespace flow {
+static QueueChunk g_defaultRuntimeStaticChunks[QUEUE_NUM_STATIC_CHUNKS];
+static Runtime g_defaultRuntime(g_defaultRuntimeStaticChunks, QUEUE_NUM_STATIC_CHUNKS);
+EEZ_FLOW_RUNTIME_STORAGE Runtime *g_runtime = &g_defaultRuntime;
+Runtime *getDefaultRuntime() {
+    return &g_defaultRuntime;
+}
+Runtime *createRuntime() {
+    auto runtime = (Runtime *)alloc(sizeof(Runtime), 0x2b7e4d19);
+    if (!runtime) {
+        return nullptr;
+    }
+    new (runtime) Runtime();
+    return runtime;
+}
+void destroyRuntime(Runtime *runtime) {
+    if (!runtime || runtime == &g_defaultRuntime) {
+        return;
+    }
+    {
+        RuntimeScope scope(runtime);
+        stopTraceRecording();
+        stopTraceReplay();
+        if (!isFlowStopped()) {
+            stop();
+            tick();
+        }
+        queueReset();
+        if (runtime->flowQueueLanes) {
+            free(runtime->flowQueueLanes);
+        }
+        unloadExternalAssets();
+        if (runtime->mainAssets) {
+            freeFlowMetadataIndex(runtime->mainAssets);
+            freeAssetsNameIndex(runtime->mainAssets);
+        }
+        if (runtime->globalVariables) {
+            for (uint32_t i = 0; i < runtime->globalVariables->count; i++) {
+                runtime->globalVariables->values[i].~Value();
+            }
+            free(runtime->globalVariables);
+        }
+        freeAssetsSections(runtime->mainAssetsSections);
+        runtime->mainAssetsSections = nullptr;
+#if defined(EEZ_FOR_LVGL) || defined(EEZ_DASHBOARD_API)
+        if (runtime->mainAssets && !runtime->mainAssetsUncompressed) {
+            free(runtime->mainAssets);
+        }
+#endif
+    }
+    runtime->~Runtime();
+    free(runtime);
+}
+Runtime *setCurrentRuntime(Runtime *runtime) {
+    auto previousRuntime = g_runtime;
+    g_runtime = runtime ? runtime : &g_defaultRuntime;
+    return previousRuntime;
+}
+void loadMainAssets(Runtime *runtime, const uint8_t *assets, uint32_t assetsSize) {
+    RuntimeScope scope(runtime);
+    eez::loadMainAssets(assets, assetsSize);
+}
+unsigned start(Runtime *runtime) {
+    RuntimeScope scope(runtime);
+    return start(runtime->mainAssets);
+}
+void tick(Runtime *runtime) {
+    RuntimeScope scope(runtime);
+    tick();
+}
+void stop(Runtime *runtime) {
+    RuntimeScope scope(runtime);
+    stop();
+}
+} 
+} 
+// -----------------------------------------------------------------------------
+// flow/timer_wheel.cpp
+// -----------------------------------------------------------------------------
+namespace eez {
+namespace flow {
+static const uint32_t TIMER_WHEEL_SLOT_MASK = TIMER_WHEEL_SLOTS - 1;
+static const uint32_t TIMER_WHEEL_MAX_DELTA = (1u << (TIMER_WHEEL_LEVELS * TIMER_WHEEL_SLOT_BITS)) - 1;
+static void timerWheelInsert(TimerWheelNode *node, int32_t minDelta) {
+    uint32_t expires = node->deadline;
+    int32_t delta = (int32_t)(expires - g_runtime->timerWheelTime);
+    if (delta < minDelta) {
+        expires = g_runtime->timerWheelTime + minDelta;
+    } else if ((uint32_t)delta > TIMER_WHEEL_MAX_DELTA) {
+        expires = g_runtime->timerWheelTime + TIMER_WHEEL_MAX_DELTA;
+    }
+    uint32_t distance = expires - g_runtime->timerWheelTime;
+    unsigned level = 0;
+    while (level < TIMER_WHEEL_LEVELS - 1 && distance >= (1u << (TIMER_WHEEL_SLOT_BITS * (level + 1)))) {
+        level++;
+    }
+    auto slot = &g_runtime->timerWheel[level][(expires >> (TIMER_WHEEL_SLOT_BITS * level)) & TIMER_WHEEL_SLOT_MASK];
+    node->slot = slot;
+    node->prev = nullptr;
+    node->next = *slot;
+    if (*slot) {
+        (*slot)->prev = node;
+    }
+    *slot = node;
+    g_runtime->timerWheelLevelSize[level]++;
+}
+static void timerWheelUnlink(TimerWheelNode *node) {
+    if (node->prev) {
+        node->prev->next = node->next;
+    } else {
+        *node->slot = node->next;
+    }
+    if (node->next) {
+        node->next->prev = node->prev;
+    }
+    g_runtime->timerWheelLevelSize[(node->slot - &g_runtime->timerWheel[0][0]) / TIMER_WHEEL_SLOTS]--;
+    node->slot = nullptr;
+}
+void timerWheelSchedule(TimerWheelNode *node, FlowState *flowState, unsigned componentIndex, uint32_t deadline) {
+    timerWheelCancel(node);
+    if (g_runtime->timerWheelSize == 0) {
+        g_runtime->timerWheelTime = millis();
+    }
+    node->flowState = flowState;
+    node->componentIndex = componentIndex;
+    node->deadline = deadline;
+    timerWheelInsert(node, 1);
+    g_runtime->timerWheelSize++;
+    incRefCounterForFlowState(flowState);
+}
+void timerWheelCancel(TimerWheelNode *node) {
+    if (!node->slot) {
+        return;
+    }
+    timerWheelUnlink(node);
+    g_runtime->timerWheelSize--;
+    decRefCounterForFlowState(node->flowState);
+}
+static void cascadeTimerWheelSlot(unsigned level, unsigned index) {
+    auto node = g_runtime->timerWheel[level][index];
+    g_runtime->timerWheel[level][index] = nullptr;
+    while (node) {
+        auto nextNode = node->next;
+        g_runtime->timerWheelLevelSize[level]--;
+        timerWheelInsert(node, 0);
+        node = nextNode;
+    }
+}
+void visitTimerWheel(uint32_t now) {
+    while (g_runtime->timerWheelSize > 0 && (int32_t)(now - g_runtime->timerWheelTime) > 0) {
+        unsigned emptyLevels = 0;
+        while (emptyLevels < TIMER_WHEEL_LEVELS && g_runtime->timerWheelLevelSize[emptyLevels] == 0) {
+            emptyLevels++;
+        }
+        if (emptyLevels > 0) {
+            uint32_t skipTo = g_runtime->timerWheelTime | ((1u << (TIMER_WHEEL_SLOT_BITS * emptyLevels)) - 1);
+            if ((int32_t)(now - skipTo) <= 0) {
+                break;
+            }
+            g_runtime->timerWheelTime = skipTo;
+        }
+        uint32_t time = ++g_runtime->timerWheelTime;
+        for (unsigned level = 1; level < TIMER_WHEEL_LEVELS && (time & ((1u << (TIMER_WHEEL_SLOT_BITS * level)) - 1)) == 0; level++) {
+            cascadeTimerWheelSlot(level, (time >> (TIMER_WHEEL_SLOT_BITS * level)) & TIMER_WHEEL_SLOT_MASK);
+        }
+        auto slot = &g_runtime->timerWheel[0][time & TIMER_WHEEL_SLOT_MASK];
+        while (*slot) {
+            auto node = *slot;
+            auto flowState = node->flowState;
+            timerWheelUnlink(node);
+            g_runtime->timerWheelSize--;
+            addToQueue(flowState, node->componentIndex, -1, -1, -1, true);
+            decRefCounterForFlowState(flowState);
+        }
+    }
+    g_runtime->timerWheelTime = now;
+}
+bool timerWheelGetNextDeadline(uint32_t &deadline) {
+    if (g_runtime->timerWheelSize == 0) {
+        return false;
+    }
+    bool found = false;
+    for (unsigned level = 0; level < TIMER_WHEEL_LEVELS; level++) {
+        if (g_runtime->timerWheelLevelSize[level] == 0) {
+            continue;
+        }
+        unsigned currentIndex = (g_runtime->timerWheelTime >> (TIMER_WHEEL_SLOT_BITS * level)) & TIMER_WHEEL_SLOT_MASK;
+        for (unsigned i = 1; i <= TIMER_WHEEL_SLOTS; i++) {
+            auto node = g_runtime->timerWheel[level][(currentIndex + i) & TIMER_WHEEL_SLOT_MASK];
+            if (node) {
+                for (; node; node = node->next) {
+                    if (!found || (int32_t)(node->deadline - deadline) < 0) {
+                        deadline = node->deadline;
+                        found = true;
+                    }
+                }
+                break;
+            }
+        }
+    }
+    return found;
+}
+size_t getTimerWheelSize() {
+    return g_runtime->timerWheelSize;
+}
+void timerWheelReset() {
+    for (unsigned level = 0; level < TIMER_WHEEL_LEVELS; level++) {
+        for (unsigned index = 0; index < TIMER_WHEEL_SLOTS; index++) {
+            for (auto node = g_runtime->timerWheel[level][index]; node; node = node->next) {
+                node->slot = nullptr;
+            }
+            g_runtime->timerWheel[level][index] = nullptr;
+        }
+        g_runtime->timerWheelLevelSize[level] = 0;
+    }
+    g_runtime->timerWheelSize = 0;
+}
+} 
+} 
+// -----------------------------------------------------------------------------
+// flow/trace.cpp
+// -----------------------------------------------------------------------------
+#include <string.h>
+namespace eez {
+namespace flow {
+struct TraceRecorder {
+    TraceWriteHook writeHook;
+    void *context;
+    uint32_t lastMillis;
+    uint32_t lastMicros;
+    TraceStats stats;
+    uint32_t size;
+    uint8_t buffer[EEZ_FLOW_TRACE_BUFFER_SIZE];
+};
+struct TraceReplayer {
+    CheckpointReader reader;
+    uint32_t lastMillis;
+    uint32_t lastMicros;
+    bool diverged;
+};
+static const uint32_t TRACE_HEADER_SIZE = sizeof(TRACE_MAGIC) + sizeof(TRACE_VERSION);
+static const uint32_t TRACE_MAX_EVENT_SIZE = 32;
+static const uint32_t TRACE_ASSETS_EXTERNAL = 1;
+static const uint8_t TRACE_VALUE_INT32 = 0xFF;
+static void flushTrace(TraceRecorder *recorder) {
+    if (recorder->size > 0) {
+        recorder->writeHook(recorder->buffer, recorder->size, recorder->context);
+        recorder->stats.size += recorder->size;
+        recorder->size = 0;
+    }
+}
+static TraceRecorder *beginTraceEvent(TraceEvent event) {
+    auto recorder = g_runtime->traceRecorder;
+    if (recorder->size + TRACE_MAX_EVENT_SIZE > EEZ_FLOW_TRACE_BUFFER_SIZE) {
+        flushTrace(recorder);
+    }
+    recorder->buffer[recorder->size++] = (uint8_t)event;
+    recorder->stats.numEvents++;
+    return recorder;
+}
+static void writeTraceVarint(TraceRecorder *recorder, uint32_t value) {
+    while (value >= 0x80) {
+        recorder->buffer[recorder->size++] = (uint8_t)(value | 0x80);
+        value >>= 7;
+    }
+    recorder->buffer[recorder->size++] = (uint8_t)value;
+}
+static void writeTraceValue(TraceRecorder *recorder, const Value &value) {
+    if (value.type == VALUE_TYPE_INT32 && value.unit == UNIT_UNKNOWN && value.options == 0 && value.dstValueType == VALUE_TYPE_UNDEFINED) {
+        if (recorder->size + TRACE_MAX_EVENT_SIZE > EEZ_FLOW_TRACE_BUFFER_SIZE) {
+            flushTrace(recorder);
+        }
+        recorder->buffer[recorder->size++] = TRACE_VALUE_INT32;
+        writeTraceVarint(recorder, ((uint32_t)value.int32Value << 1) ^ (uint32_t)(value.int32Value >> 31));
+        return;
+    }
+    CheckpointWriter sizeWriter = { nullptr, 0, 0 };
+    if (!checkpointWriteValue(sizeWriter, value)) {
+        recorder->stats.numUnsupportedValues++;
+        writeTraceValue(recorder, Value());
+        return;
+    }
+    if (recorder->size + sizeWriter.size > EEZ_FLOW_TRACE_BUFFER_SIZE) {
+        flushTrace(recorder);
+    }
+    if (sizeWriter.size <= EEZ_FLOW_TRACE_BUFFER_SIZE) {
+        CheckpointWriter writer = { recorder->buffer + recorder->size, sizeWriter.size, 0 };
+        checkpointWriteValue(writer, value);
+        recorder->size += writer.size;
+        return;
+    }
+    auto buffer = (uint8_t *)alloc(sizeWriter.size, 0x7e3a5c01);
+    if (!buffer) {
+        recorder->stats.numUnsupportedValues++;
+        writeTraceValue(recorder, Value());
+        return;
+    }
+    CheckpointWriter writer = { buffer, sizeWriter.size, 0 };
+    checkpointWriteValue(writer, value);
+    recorder->writeHook(buffer, writer.size, recorder->context);
+    recorder->stats.size += writer.size;
+    free(buffer);
+}
+static uint32_t getTraceAssetsFlags(Assets *assets) {
+    return assets != g_runtime->mainAssets && assets == g_runtime->externalAssets ? TRACE_ASSETS_EXTERNAL : 0;
+}
+static bool expectTraceEvent(TraceReplayer *replayer, TraceEvent event) {
+    auto &reader = replayer->reader;
+    if (replayer->diverged || reader.offset >= reader.size || reader.data[reader.offset] != event) {
+        replayer->diverged = true;
+        return false;
+    }
+    reader.offset++;
+    return true;
+}
+static bool readTraceVarint(TraceReplayer *replayer, uint32_t &value) {
+    auto &reader = replayer->reader;
+    value = 0;
+    for (uint32_t shift = 0; shift < 35; shift += 7) {
+        if (reader.offset >= reader.size) {
             break;
         }
-	}
+        uint8_t byte = reader.data[reader.offset++];
+        value |= (uint32_t)(byte & 0x7F) << shift;
+        if (!(byte & 0x80)) {
+            return true;
+        }
+    }
+    replayer->diverged = true;
+    return false;
+}
+static bool readTraceValue(TraceReplayer *replayer, Value &value) {
+    auto &reader = replayer->reader;
+    if (reader.offset < reader.size && reader.data[reader.offset] == TRACE_VALUE_INT32) {
+        reader.offset++;
+        uint32_t zigzag;
+        if (!readTraceVarint(replayer, zigzag)) {
+            return false;
+        }
+        value = Value((int)((zigzag >> 1) ^ (0 - (zigzag & 1))), VALUE_TYPE_INT32);
+        return true;
+    }
+    if (!checkpointReadValue(reader, value)) {
+        replayer->diverged = true;
+        return false;
+    }
+    return true;
+}
+static FlowState *findTracedFlowState(FlowState *flowState, uint32_t traceId) {
+    for (; flowState; flowState = flowState->nextSibling) {
+        if (flowState->traceId == traceId) {
+            return flowState;
+        }
+        auto childFlowState = findTracedFlowState(flowState->firstChild, traceId);
+        if (childFlowState) {
+            return childFlowState;
+        }
+    }
+    return nullptr;
+}
+static bool readTraceFlowState(TraceReplayer *replayer, FlowState *&flowState) {
+    uint32_t traceId;
+    if (!readTraceVarint(replayer, traceId)) {
+        return false;
+    }
+    if (traceId == 0) {
+        flowState = nullptr;
+        return true;
+    }
+    flowState = findTracedFlowState(g_runtime->firstFlowState, traceId);
+    if (!flowState) {
+        replayer->diverged = true;
+        return false;
+    }
+    return true;
+}
+static bool readTraceAssets(TraceReplayer *replayer, Assets *&assets) {
+    uint32_t flags;
+    if (!readTraceVarint(replayer, flags)) {
+        return false;
+    }
+    assets = flags & TRACE_ASSETS_EXTERNAL ? g_runtime->externalAssets : g_runtime->mainAssets;
+    if (!assets) {
+        replayer->diverged = true;
+        return false;
+    }
+    return true;
+}
+static bool replayTraceExternalEvent(TraceReplayer *replayer, uint8_t event) {
+    TraceEngineScope traceEngineScope(true);
+    if (event == TRACE_EVENT_PAGE) {
+        Assets *assets;
+        uint32_t flowIndex;
+        if (!readTraceAssets(replayer, assets) || !readTraceVarint(replayer, flowIndex) || flowIndex >= assets->flowDefinition->flows.count) {
+            return false;
+        }
+        initPageFlowState(assets, flowIndex, nullptr, 0);
+        return true;
+    }
+#if defined(EEZ_FOR_LVGL)
+    if (event == TRACE_EVENT_USER_WIDGET) {
+        FlowState *flowState;
+        uint32_t componentIndex;
+        if (
+            !readTraceFlowState(replayer, flowState) || !flowState ||
+            !readTraceVarint(replayer, componentIndex) ||
+            componentIndex >= flowState->flow->components.count ||
+            flowState->flow->components[componentIndex]->type != defs_v3::COMPONENT_TYPE_LVGL_USER_WIDGET_WIDGET ||
+            flowState->componenentExecutionStates[componentIndex]
+        ) {
+            return false;
+        }
+        createUserWidgetFlowState(flowState, componentIndex);
+        return true;
+    }
+#endif
+    if (event == TRACE_EVENT_PROPAGATE_VALUE) {
+        FlowState *flowState;
+        uint32_t componentIndex;
+        uint32_t outputIndex;
+        Value value;
+        if (
+            !readTraceFlowState(replayer, flowState) || !flowState ||
+            !readTraceVarint(replayer, componentIndex) ||
+            !readTraceVarint(replayer, outputIndex) ||
+            !readTraceValue(replayer, value)
+        ) {
+            return false;
+        }
+        if (componentIndex == 0) {
+            if (outputIndex < flowState->flowDefinition->flows.count) {
+                return false;
+            }
+        } else if (componentIndex > flowState->flow->components.count || outputIndex >= flowState->flow->components[componentIndex - 1]->outputs.count) {
+            return false;
+        }
+        propagateValue(flowState, componentIndex - 1, outputIndex, value);
+        return true;
+    }
+    if (event == TRACE_EVENT_ADD_TO_QUEUE) {
+        FlowState *flowState;
+        uint32_t componentIndex;
+        uint32_t sourceComponentIndex;
+        uint32_t sourceOutputIndex;
+        uint32_t targetInputIndex;
+        uint32_t continuousTask;
+        if (
+            !readTraceFlowState(replayer, flowState) || !flowState ||
+            !readTraceVarint(replayer, componentIndex) ||
+            !readTraceVarint(replayer, sourceComponentIndex) ||
+            !readTraceVarint(replayer, sourceOutputIndex) ||
+            !readTraceVarint(replayer, targetInputIndex) ||
+            !readTraceVarint(replayer, continuousTask) ||
+            componentIndex >= flowState->flow->components.count
+        ) {
+            return false;
+        }
+        addToQueue(flowState, componentIndex, (int)sourceComponentIndex - 1, (int)sourceOutputIndex - 1, (int)targetInputIndex - 1, continuousTask != 0);
+        return true;
+    }
+    if (event == TRACE_EVENT_SET_GLOBAL_VARIABLE) {
+        Assets *assets;
+        uint32_t globalVariableIndex;
+        Value value;
+        if (
+            !readTraceAssets(replayer, assets) ||
+            !readTraceVarint(replayer, globalVariableIndex) ||
+            !readTraceValue(replayer, value)
+        ) {
+            return false;
+        }
+        setGlobalVariable(assets, globalVariableIndex, value);
+        return true;
+    }
+    if (event == TRACE_EVENT_SET_USER_PROPERTY) {
+        uint32_t propertyIndex;
+        Value value;
+        if (!readTraceVarint(replayer, propertyIndex) || !readTraceValue(replayer, value)) {
+            return false;
+        }
+        setUserProperty(propertyIndex, value);
+        return true;
+    }
+    if (event == TRACE_EVENT_STOP) {
+        stop();
+        return true;
+    }
     return false;
 }
+static TraceReplayResult replayTraceEvents(TraceReplayer *replayer, TraceEvent endEvent) {
+    auto &reader = replayer->reader;
+    while (!replayer->diverged) {
+        if (reader.offset >= reader.size) {
+            if (endEvent == TRACE_EVENT_TICK) {
+                return TRACE_REPLAY_END;
+            }
+            break;
+        }
+        uint8_t event = reader.data[reader.offset++];
+        if (event == endEvent) {
+            if (endEvent == TRACE_EVENT_TICK) {
+                tick();
+            }
+            return replayer->diverged ? TRACE_REPLAY_DIVERGED : TRACE_REPLAY_TICK;
+        }
+        if (!replayTraceExternalEvent(replayer, event)) {
+            break;
+        }
+    }
+    replayer->diverged = true;
+    return TRACE_REPLAY_DIVERGED;
+}
+bool startTraceRecording(TraceWriteHook writeHook, void *context) {
+    auto runtime = g_runtime;
+    if (!writeHook || runtime->traceMode != TRACE_MODE_OFF || !isFlowStopped()) {
+        return false;
+    }
+    auto recorder = (TraceRecorder *)alloc(sizeof(TraceRecorder), 0x7e3a5c02);
+    if (!recorder) {
+        return false;
+    }
+    memset(recorder, 0, sizeof(TraceRecorder));
+    recorder->writeHook = writeHook;
+    recorder->context = context;
+    memcpy(recorder->buffer, &TRACE_MAGIC, sizeof(TRACE_MAGIC));
+    memcpy(recorder->buffer + sizeof(TRACE_MAGIC), &TRACE_VERSION, sizeof(TRACE_VERSION));
+    recorder->size = TRACE_HEADER_SIZE;
+    runtime->traceRecorder = recorder;
+    runtime->traceMode = TRACE_MODE_RECORD;
+    return true;
+}
+void stopTraceRecording() {
+    auto runtime = g_runtime;
+    if (runtime->traceMode != TRACE_MODE_RECORD) {
+        return;
+    }
+    flushTrace(runtime->traceRecorder);
+    free(runtime->traceRecorder);
+    runtime->traceRecorder = nullptr;
+    runtime->traceMode = TRACE_MODE_OFF;
+}
+bool getTraceStats(TraceStats &stats) {
+    auto recorder = g_runtime->traceRecorder;
+    if (!recorder) {
+        return false;
+    }
+    stats = recorder->stats;
+    stats.size += recorder->size;
+    return true;
+}
+bool startTraceReplay(const uint8_t *trace, size_t traceSize) {
+    auto runtime = g_runtime;
+    if (!trace || traceSize < TRACE_HEADER_SIZE || runtime->traceMode != TRACE_MODE_OFF || !isFlowStopped()) {
+        return false;
+    }
+    uint32_t magic;
+    uint16_t version;
+    memcpy(&magic, trace, sizeof(magic));
+    memcpy(&version, trace + sizeof(magic), sizeof(version));
+    if (magic != TRACE_MAGIC || version != TRACE_VERSION) {
+        return false;
+    }
+    auto replayer = (TraceReplayer *)alloc(sizeof(TraceReplayer), 0x7e3a5c03);
+    if (!replayer) {
+        return false;
+    }
+    memset(replayer, 0, sizeof(TraceReplayer));
+    replayer->reader.data = trace;
+    replayer->reader.size = traceSize;
+    replayer->reader.offset = TRACE_HEADER_SIZE;
+    runtime->traceReplayer = replayer;
+    runtime->traceMode = TRACE_MODE_REPLAY;
+    return true;
+}
+TraceReplayResult replayTraceStep() {
+    auto replayer = g_runtime->traceReplayer;
+    if (!replayer) {
+        return TRACE_REPLAY_END;
+    }
+    if (replayer->diverged) {
+        return TRACE_REPLAY_DIVERGED;
+    }
+    return replayTraceEvents(replayer, TRACE_EVENT_TICK);
+}
+void stopTraceReplay() {
+    auto runtime = g_runtime;
+    if (runtime->traceMode != TRACE_MODE_REPLAY) {
+        return;
+    }
+    free(runtime->traceReplayer);
+    runtime->traceReplayer = nullptr;
+    runtime->traceMode = TRACE_MODE_OFF;
+}
+void traceStart(Assets *assets) {
+    auto runtime = g_runtime;
+    uint32_t flowDefinitionHash = getFlowDefinitionHash(static_cast<FlowDefinition *>(assets->flowDefinition));
+    if (runtime->traceMode == TRACE_MODE_RECORD) {
+        auto recorder = beginTraceEvent(TRACE_EVENT_START);
+        writeTraceVarint(recorder, flowDefinitionHash);
+        return;
+    }
+    auto replayer = runtime->traceReplayer;
+    uint32_t tracedFlowDefinitionHash;
+    if (expectTraceEvent(replayer, TRACE_EVENT_START) && readTraceVarint(replayer, tracedFlowDefinitionHash) && tracedFlowDefinitionHash != flowDefinitionHash) {
+        replayer->diverged = true;
+    }
+}
+void recordTraceTick() {
+    beginTraceEvent(TRACE_EVENT_TICK);
+}
+uint32_t traceClock(TraceEvent event, uint32_t (*readClock)()) {
+    auto runtime = g_runtime;
+    if (!runtime->traceInEngine) {
+        return readClock();
+    }
+    if (runtime->traceMode == TRACE_MODE_RECORD) {
+        uint32_t value = readClock();
+        auto recorder = beginTraceEvent(event);
+        auto &lastValue = event == TRACE_EVENT_MILLIS ? recorder->lastMillis : recorder->lastMicros;
+        int32_t delta = (int32_t)(value - lastValue);
+        writeTraceVarint(recorder, ((uint32_t)delta << 1) ^ (uint32_t)(delta >> 31));
+        lastValue = value;
+        return value;
+    }
+    auto replayer = runtime->traceReplayer;
+    auto &lastValue = event == TRACE_EVENT_MILLIS ? replayer->lastMillis : replayer->lastMicros;
+    uint32_t delta;
+    if (expectTraceEvent(replayer, event) && readTraceVarint(replayer, delta)) {
+        lastValue += (delta >> 1) ^ (0 - (delta & 1));
+    }
+    return lastValue;
+}
+double traceDateNow(double (*readDateNow)()) {
+    auto runtime = g_runtime;
+    if (!runtime->traceInEngine) {
+        return readDateNow();
+    }
+    double value;
+    if (runtime->traceMode == TRACE_MODE_RECORD) {
+        value = readDateNow();
+        auto recorder = beginTraceEvent(TRACE_EVENT_DATE_NOW);
+        memcpy(recorder->buffer + recorder->size, &value, sizeof(value));
+        recorder->size += sizeof(value);
+        return value;
+    }
+    auto replayer = runtime->traceReplayer;
+    if (!expectTraceEvent(replayer, TRACE_EVENT_DATE_NOW) || !checkpointRead(replayer->reader, &value, sizeof(value))) {
+        replayer->diverged = true;
+        return 0;
+    }
+    return value;
+}
+Value traceNativeVariable(int16_t id, Value (*readNativeVariable)(int16_t id)) {
+    auto runtime = g_runtime;
+    if (!runtime->traceInEngine) {
+        return readNativeVariable(id);
+    }
+    if (runtime->traceMode == TRACE_MODE_RECORD) {
+        Value value = readNativeVariable(id);
+        auto recorder = beginTraceEvent(TRACE_EVENT_NATIVE_VARIABLE);
+        writeTraceVarint(recorder, (uint16_t)id);
+        writeTraceValue(recorder, value);
+        return value;
+    }
+    auto replayer = runtime->traceReplayer;
+    uint32_t tracedId;
+    Value value;
+    if (!expectTraceEvent(replayer, TRACE_EVENT_NATIVE_VARIABLE) || !readTraceVarint(replayer, tracedId) || !readTraceValue(replayer, value)) {
+        return Value();
+    }
+    if (tracedId != (uint16_t)id) {
+        replayer->diverged = true;
+    }
+    return value;
+}
+void traceActionFunction(int actionId, void (*executeAction)(int actionId)) {
+    auto runtime = g_runtime;
+    if (!runtime->traceInEngine) {
+        executeAction(actionId);
+        return;
+    }
+    if (runtime->traceMode == TRACE_MODE_RECORD) {
+        auto recorder = beginTraceEvent(TRACE_EVENT_ACTION_BEGIN);
+        writeTraceVarint(recorder, (uint32_t)actionId);
+        {
+            TraceEngineScope traceEngineScope(false);
+            executeAction(actionId);
+        }
+        beginTraceEvent(TRACE_EVENT_ACTION_END);
+        return;
+    }
+    auto replayer = runtime->traceReplayer;
+    uint32_t tracedActionId;
+    if (!expectTraceEvent(replayer, TRACE_EVENT_ACTION_BEGIN) || !readTraceVarint(replayer, tracedActionId)) {
+        return;
+    }
+    if (tracedActionId != (uint32_t)actionId) {
+        replayer->diverged = true;
+        return;
+    }
+    replayTraceEvents(replayer, TRACE_EVENT_ACTION_END);
+}
+void recordTracePage(Assets *assets, int flowIndex) {
+    auto recorder = beginTraceEvent(TRACE_EVENT_PAGE);
+    writeTraceVarint(recorder, getTraceAssetsFlags(assets));
+    writeTraceVarint(recorder, (uint32_t)flowIndex);
+}
+void recordTraceUserWidget(FlowState *flowState, unsigned componentIndex) {
+    auto recorder = beginTraceEvent(TRACE_EVENT_USER_WIDGET);
+    writeTraceVarint(recorder, flowState->traceId);
+    writeTraceVarint(recorder, componentIndex);
+}
+void recordTracePropagateValue(FlowState *flowState, unsigned componentIndex, unsigned outputIndex, const Value &value) {
+    auto recorder = beginTraceEvent(TRACE_EVENT_PROPAGATE_VALUE);
+    writeTraceVarint(recorder, flowState->traceId);
+    writeTraceVarint(recorder, componentIndex + 1);
+    writeTraceVarint(recorder, outputIndex);
+    writeTraceValue(recorder, value);
+}
+void recordTraceAddToQueue(FlowState *flowState, unsigned componentIndex, int sourceComponentIndex, int sourceOutputIndex, int targetInputIndex, bool continuousTask) {
+    auto recorder = beginTraceEvent(TRACE_EVENT_ADD_TO_QUEUE);
+    writeTraceVarint(recorder, flowState->traceId);
+    writeTraceVarint(recorder, componentIndex);
+    writeTraceVarint(recorder, (uint32_t)(sourceComponentIndex + 1));
+    writeTraceVarint(recorder, (uint32_t)(sourceOutputIndex + 1));
+    writeTraceVarint(recorder, (uint32_t)(targetInputIndex + 1));
+    writeTraceVarint(recorder, continuousTask ? 1 : 0);
+}
+void recordTraceSetGlobalVariable(Assets *assets, uint32_t globalVariableIndex, const Value &value) {
+    auto recorder = beginTraceEvent(TRACE_EVENT_SET_GLOBAL_VARIABLE);
+    writeTraceVarint(recorder, getTraceAssetsFlags(assets));
+    writeTraceVarint(recorder, globalVariableIndex);
+    writeTraceValue(recorder, value);
+}
+void recordTraceSetUserProperty(unsigned propertyIndex, const Value &value) {
+    auto recorder = beginTraceEvent(TRACE_EVENT_SET_USER_PROPERTY);
+    writeTraceVarint(recorder, propertyIndex);
+    writeTraceValue(recorder, value);
+}
+void recordTraceStop() {
+    beginTraceEvent(TRACE_EVENT_STOP);
+}
 } 
 } 
 // -----------------------------------------------------------------------------
@@ -9848,25 +14020,109 @@ struct WatchListNode {
     unsigned componentIndex;
     WatchListNode *prev;
     WatchListNode *next;
+    bool isTracked;
+    unsigned numDependencies;
+    Value **dependencies;
+    Value *snapshots;
 };
-struct WatchList {
-    WatchListNode *first;
-    WatchListNode *last;
-};
-static WatchList g_watchList;
+static bool isImmutableValue(const Value &value) {
+    switch (value.type) {
+    case VALUE_TYPE_UNDEFINED:
+    case VALUE_TYPE_NULL:
+    case VALUE_TYPE_BOOLEAN:
+    case VALUE_TYPE_INT8:
+    case VALUE_TYPE_UINT8:
+    case VALUE_TYPE_INT16:
+    case VALUE_TYPE_UINT16:
+    case VALUE_TYPE_INT32:
+    case VALUE_TYPE_UINT32:
+    case VALUE_TYPE_INT64:
+    case VALUE_TYPE_UINT64:
+    case VALUE_TYPE_FLOAT:
+    case VALUE_TYPE_DOUBLE:
+    case VALUE_TYPE_STRING:
+    case VALUE_TYPE_STRING_ASSET:
+    case VALUE_TYPE_STRING_REF:
+    case VALUE_TYPE_DATE:
+    case VALUE_TYPE_ENUM:
+        return true;
+    default:
+        return false;
+    }
+}
+static int getWatchDependencies(FlowState *flowState, const uint8_t *instructions, Value **dependencies) {
+    auto flowDefinition = flowState->flowDefinition;
+    auto flow = flowState->flow;
+    int numDependencies = 0;
+    for (int i = 0; ; i += 2) {
+        uint16_t instruction = instructions[i] + (instructions[i + 1] << 8);
+        auto instructionType = instruction & EXPR_EVAL_INSTRUCTION_TYPE_MASK;
+        auto instructionArg = instruction & EXPR_EVAL_INSTRUCTION_PARAM_MASK;
+        Value *dependency = nullptr;
+        if (instructionType == EXPR_EVAL_INSTRUCTION_TYPE_PUSH_CONSTANT || instructionType == EXPR_EVAL_INSTRUCTION_ARRAY_ELEMENT) {
+            continue;
+        } else if (instructionType == EXPR_EVAL_INSTRUCTION_TYPE_PUSH_INPUT) {
+            dependency = &flowState->values[instructionArg];
+        } else if (instructionType == EXPR_EVAL_INSTRUCTION_TYPE_PUSH_LOCAL_VAR) {
+            dependency = &flowState->values[flow->componentInputs.count + instructionArg];
+        } else if (instructionType == EXPR_EVAL_INSTRUCTION_TYPE_PUSH_GLOBAL_VAR) {
+            if ((uint32_t)instructionArg >= flowDefinition->globalVariables.count) {
+                return -1;
+            }
+            if (g_runtime->globalVariables) {
+                dependency = g_runtime->globalVariables->values + instructionArg;
+            } else {
+                dependency = flowDefinition->globalVariables[instructionArg];
+            }
+        } else if (instructionType == EXPR_EVAL_INSTRUCTION_TYPE_OPERATION) {
+            if (!isPureOperation(instructionArg)) {
+                return -1;
+            }
+            continue;
+        } else if (instructionType == EXPR_EVAL_INSTRUCTION_TYPE_PUSH_OUTPUT) {
+            return -1;
+        } else {
+            break;
+        }
+        if (dependencies) {
+            dependencies[numDependencies] = dependency;
+        }
+        numDependencies++;
+    }
+    return numDependencies;
+}
 WatchListNode *watchListAdd(FlowState *flowState, unsigned componentIndex) {
-    auto node = (WatchListNode *)alloc(sizeof(WatchListNode), 0x00864d67);
-    node->prev = g_watchList.last;
-    if (g_watchList.last != 0) {
-        g_watchList.last->next = node;
+    auto component = flowState->flow->components[componentIndex];
+    auto instructions = component->properties[defs_v3::WATCH_VARIABLE_ACTION_COMPONENT_PROPERTY_VARIABLE]->evalInstructions;
+    auto numDependencies = getWatchDependencies(flowState, instructions, nullptr);
+    auto numTrackedDependencies = numDependencies > 0 ? numDependencies : 0;
+    auto node = (WatchListNode *)alloc(
+        sizeof(WatchListNode) +
+        numTrackedDependencies * sizeof(Value) +
+        numTrackedDependencies * sizeof(Value *),
+        0x00864d67
+    );
+    node->prev = g_runtime->watchList.last;
+    if (g_runtime->watchList.last != 0) {
+        g_runtime->watchList.last->next = node;
     }
-    g_watchList.last = node;
-    if (g_watchList.first == 0) {
-        g_watchList.first = node;
+    g_runtime->watchList.last = node;
+    if (g_runtime->watchList.first == 0) {
+        g_runtime->watchList.first = node;
     }
     node->next = 0;
     node->flowState = flowState;
     node->componentIndex = componentIndex;
+    node->isTracked = numDependencies >= 0;
+    node->numDependencies = numTrackedDependencies;
+    node->snapshots = (Value *)(node + 1);
+    node->dependencies = (Value **)(node->snapshots + numTrackedDependencies);
+    if (numTrackedDependencies > 0) {
+        getWatchDependencies(flowState, instructions, node->dependencies);
+    }
+    for (unsigned i = 0; i < node->numDependencies; i++) {
+        new (node->snapshots + i) Value(*node->dependencies[i]);
+    }
     incRefCounterForFlowState(flowState);
     return node;
 }
@@ -9874,19 +14130,47 @@ void watchListRemove(WatchListNode *node) {
     if (node->prev) {
         node->prev->next = node->next;
     } else {
-        g_watchList.first = node->next;
+        g_runtime->watchList.first = node->next;
     }
     if (node->next) {
         node->next->prev = node->prev;
     } else {
-        g_watchList.last = node->prev;
+        g_runtime->watchList.last = node->prev;
+    }
+    for (unsigned i = 0; i < node->numDependencies; i++) {
+        (node->snapshots + i)->~Value();
     }
     free(node);
 }
+static bool hasWatchDependencyChanged(WatchListNode *node) {
+    if (!node->isTracked) {
+        return true;
+    }
+    for (unsigned i = 0; i < node->numDependencies; i++) {
+        auto &value = *node->dependencies[i];
+        auto &snapshot = node->snapshots[i];
+        if (
+            !isImmutableValue(value) ||
+            value.type != snapshot.type ||
+            value.unit != snapshot.unit ||
+            value.options != snapshot.options ||
+            value.uint64Value != snapshot.uint64Value
+        ) {
+            return true;
+        }
+    }
+    return false;
+}
+static void updateWatchSnapshots(WatchListNode *node) {
+    for (unsigned i = 0; i < node->numDependencies; i++) {
+        node->snapshots[i] = *node->dependencies[i];
+    }
+}
 void visitWatchList() {
-    for (auto node = g_watchList.first; node; ) {
+    for (auto node = g_runtime->watchList.first; node; ) {
         auto nextNode = node->next;
-        if (canExecuteStep(node->flowState, node->componentIndex)) {
+        if (canExecuteStep(node->flowState, node->componentIndex) && hasWatchDependencyChanged(node)) {
+            updateWatchSnapshots(node);
             executeWatchVariableComponent(node->flowState, node->componentIndex);
         }
         decRefCounterForFlowState(node->flowState);
@@ -9899,8 +14183,11 @@ void visitWatchList() {
         node = nextNode;
     }
 }
+bool isWatchListEmpty() {
+    return g_runtime->watchList.first == nullptr;
+}
 void watchListReset() {
-    for (auto node = g_watchList.first; node;) {
+    for (auto node = g_runtime->watchList.first; node;) {
         auto nextNode = node->next;
         watchListRemove(node);
         node = nextNode;
@@ -1,4 +1,4 @@
-/* Autogenerated on September 17, 2024 4:49:42 PM from eez-framework commit 03a09f68d00aaa6366fb2b5132e6180a4c8711ca */
+/* Autogenerated on September 17, 2024 4:49:42 PM from eez-framework commit 03a09f68d00aaa6366fb2b5132e6180a4c8711ca, modified by hand since then (see tools/eez-framework-amalgamation/README.md) */
 /*
  * eez-framework
  *
@@ -15,6 +15,7 @@
 #define EEZ_FOR_LVGL_SHA256_OPTION 1
 #define EEZ_FLOW_QUEUE_SIZE 1000
 #define EEZ_FLOW_EVAL_STACK_SIZE 20
+#define EEZ_ASSETS_PARALLEL_DECOMPRESSION 0
 
 // -----------------------------------------------------------------------------
 // conf-internal.h
@@ -635,6 +636,9 @@ enum OperationTypes {
     OPERATION_TYPE_FLOW_GET_BITMAP_INDEX = 70,
     OPERATION_TYPE_FLOW_GET_BITMAP_AS_DATA_URL = 78,
     OPERATION_TYPE_CRYPTO_SHA256 = 74,
+    OPERATION_TYPE_CRYPTO_SHA256_INIT = 90,
+    OPERATION_TYPE_CRYPTO_SHA256_UPDATE = 91,
+    OPERATION_TYPE_CRYPTO_SHA256_FINAL = 92,
     OPERATION_TYPE_DATE_NOW = 34,
     OPERATION_TYPE_DATE_TO_STRING = 35,
     OPERATION_TYPE_DATE_TO_LOCALE_STRING = 59,
@@ -647,6 +651,7 @@ enum OperationTypes {
     OPERATION_TYPE_DATE_GET_SECONDS = 65,
     OPERATION_TYPE_DATE_GET_MILLISECONDS = 66,
     OPERATION_TYPE_DATE_MAKE = 67,
+    OPERATION_TYPE_DATE_BREAK = 88,
     OPERATION_TYPE_MATH_SIN = 37,
     OPERATION_TYPE_MATH_COS = 38,
     OPERATION_TYPE_MATH_POW = 68,
@@ -675,8 +680,10 @@ enum OperationTypes {
     OPERATION_TYPE_ARRAY_REMOVE = 57,
     OPERATION_TYPE_ARRAY_CLONE = 58,
     OPERATION_TYPE_BLOB_ALLOCATE = 75,
+    OPERATION_TYPE_BLOB_CRC32 = 93,
     OPERATION_TYPE_JSON_GET = 76,
     OPERATION_TYPE_JSON_CLONE = 77,
+    OPERATION_TYPE_JSON_PARSE = 89,
     OPERATION_TYPE_EVENT_GET_CODE = 81,
     OPERATION_TYPE_EVENT_GET_CURRENT_TARGET = 82,
     OPERATION_TYPE_EVENT_GET_TARGET = 83,
@@ -1217,6 +1224,7 @@ struct Value {
     bool toBool(int *err = nullptr) const;
 	Value toString(uint32_t id) const;
 	static Value makeStringRef(const char *str, int len, uint32_t id);
+	static Value makeStringSliceRef(const Value &bufferValue, char *str, uint32_t id);
 	static Value concatenateString(const Value &str1, const Value &str2);
     static Value makeArrayRef(int arraySize, int arrayType, uint32_t id);
     static Value makeArrayElementRef(Value arrayValue, int elementIndex, uint32_t id);
@@ -1270,6 +1278,12 @@ struct StringRef : public Ref {
     }
 	char *str;
 };
+struct StringSliceRef : public StringRef {
+    ~StringSliceRef() {
+        str = nullptr;
+    }
+    Value bufferValue;
+};
 struct ArrayValue {
 	uint32_t arraySize;
     uint32_t arrayType;
@@ -1523,6 +1537,7 @@ void executeActionFunction(int actionId);
 namespace eez {
 static const uint32_t HEADER_TAG = 0x5A45457E; 
 static const uint32_t HEADER_TAG_COMPRESSED = 0x7A65657E; 
+static const uint32_t HEADER_TAG_SECTIONED = 0x7365657E; 
 static const uint8_t PROJECT_VERSION_V2 = 2;
 static const uint8_t PROJECT_VERSION_V3 = 3;
 static const uint8_t ASSETS_TYPE_FIRMWARE = 1;
@@ -1538,11 +1553,37 @@ struct Header {
     uint8_t reserved;
 	uint32_t decompressedSize;
 };
-extern bool g_isMainAssetsLoaded;
+#if !defined(EEZ_ASSETS_PARALLEL_DECOMPRESSION)
+#define EEZ_ASSETS_PARALLEL_DECOMPRESSION 0
+#endif
+#if EEZ_ASSETS_PARALLEL_DECOMPRESSION && defined(__EMSCRIPTEN__)
+#error EEZ_ASSETS_PARALLEL_DECOMPRESSION is not supported on Emscripten
+#endif
+#if !defined(EEZ_ASSETS_DECOMPRESSION_THREADS)
+#define EEZ_ASSETS_DECOMPRESSION_THREADS 0
+#endif
+static const uint8_t ASSETS_SECTION_CORE = 0;
+static const uint8_t ASSETS_SECTION_LANGUAGE = 1;
+static const uint8_t ASSETS_SECTION_NUM_TYPES = 2;
+struct AssetsSection {
+    uint8_t type;
+    uint8_t reserved1;
+    uint16_t reserved2;
+    uint32_t index;
+    uint32_t compressedOffset;
+    uint32_t compressedSize;
+    uint32_t decompressedSize;
+};
+struct AssetsSectionStats {
+    uint32_t numSections;
+    uint32_t numResidentSections;
+    uint32_t residentSize;
+    uint32_t numDecompressions;
+    uint32_t numCoreBlocks;
+    uint32_t numDecompressionThreads;
+};
+struct AssetsSections;
 struct Assets;
-extern Assets *g_mainAssets;
-extern bool g_mainAssetsUncompressed;
-extern Assets *g_externalAssets;
 template<typename T>
 struct AssetsPtr {
     AssetsPtr() : offset(0) {}
@@ -1848,8 +1889,41 @@ struct Assets {
 	AssetsPtr<FlowDefinition> flowDefinition;
     ListOfAssetsPtr<Language> languages;
 };
+static const uint8_t ASSETS_NAME_TABLE_BITMAPS = 0;
+static const uint8_t ASSETS_NAME_TABLE_ACTIONS = 1;
+static const uint8_t ASSETS_NAME_TABLE_VARIABLES = 2;
+static const uint8_t ASSETS_NAME_TABLE_LANGUAGES = 3;
+static const uint8_t ASSETS_NAME_TABLE_NUM = 4;
+typedef const char *(*AssetsNameGetter)(const void *items, uint32_t index);
+struct AssetsNameSlot {
+    uint32_t hash;
+    uint32_t index;
+};
+struct AssetsNameTable {
+    const void *items;
+    uint32_t count;
+    AssetsNameGetter getName;
+    uint32_t mask;
+    AssetsNameSlot *slots;
+};
+struct AssetsNameIndex {
+    Assets *assets;
+    AssetsNameTable tables[ASSETS_NAME_TABLE_NUM];
+};
+bool buildAssetsNameTable(AssetsNameTable &table, const void *items, uint32_t count, AssetsNameGetter getName);
+void freeAssetsNameTable(AssetsNameTable &table);
+int32_t findAssetsNameTable(const AssetsNameTable &table, const char *name);
+void buildAssetsNameIndex(Assets *assets);
+void freeAssetsNameIndex(Assets *assets);
+int32_t findAssetsName(Assets *assets, uint8_t nameTable, const char *name);
 bool decompressAssetsData(const uint8_t *assetsData, uint32_t assetsDataSize, Assets *decompressedAssets, uint32_t maxDecompressedAssetsSize, int *err);
 void loadMainAssets(const uint8_t *assets, uint32_t assetsSize);
+void *getAssetsSection(Assets *assets, uint8_t type, uint32_t index);
+const ListOfAssetsPtr<const char> *getLanguageTranslations(Assets *assets, uint32_t languageIndex);
+AssetsSectionStats getAssetsSectionStats();
+void freeAssetsSections(AssetsSections *sections);
+void setAssetsDecompressionThreads(unsigned numThreads);
+unsigned getAssetsDecompressionThreads();
 bool loadExternalAssets(const char *filePath, int *err);
 void unloadExternalAssets();
 #if EEZ_OPTION_GUI
@@ -1973,6 +2047,7 @@ enum TestResult {
 	TEST_WARNING
 };
 uint32_t millis();
+uint32_t micros();
 extern bool g_shutdown;
 void shutdown();
 } 
@@ -2138,6 +2213,10 @@ void stringAppendPower(char *str, size_t maxStrLength, float value);
 void stringAppendDuration(char *str, size_t maxStrLength, float value);
 void stringAppendLoad(char *str, size_t maxStrLength, float value);
 uint32_t crc32(const uint8_t *message, size_t size);
+uint32_t crc32Bitwise(const uint8_t *message, size_t size);
+#if !defined(EEZ_PLATFORM_STM32) || defined(EEZ_FOR_LVGL)
+void crc32UsePortable(bool portable);
+#endif
 uint8_t toBCD(uint8_t bin);
 uint8_t fromBCD(uint8_t bcd);
 float roundPrec(float a, float prec);
@@ -2244,7 +2323,6 @@ struct GlobalVariables {
     uint32_t count;
     Value values[1];
 };
-extern struct GlobalVariables *g_globalVariables;
 void initGlobalVariables(Assets *assets);
 static const int UNDEFINED_VALUE_INDEX = 0;
 static const int NULL_VALUE_INDEX = 1;
@@ -2263,38 +2341,94 @@ struct ComponenentExecutionState {
 struct CatchErrorComponenentExecutionState : public ComponenentExecutionState {
 	Value message;
 };
+static const uint8_t INPUT_METADATA_FLAG_MANDATORY = 1;
+static const uint8_t INPUT_METADATA_FLAG_SEQ = 2;
+#if !defined(EEZ_FLOW_STATE_POOL_SIZE)
+#define EEZ_FLOW_STATE_POOL_SIZE 4
+#endif
+#if !defined(EEZ_FLOW_INLINE_ACTION_MAX_TASKS)
+#define EEZ_FLOW_INLINE_ACTION_MAX_TASKS 32
+#endif
+struct InputMetadata {
+    uint16_t componentIndex;
+    uint8_t flags;
+};
+struct ComponentMetadata {
+    int16_t seqOutIndex;
+    uint16_t numMandatoryInputs;
+    uint16_t numSeqInputs;
+    uint16_t fanOut;
+};
+struct FlowMetadata {
+    ComponentMetadata *components;
+    InputMetadata *inputs;
+    uint16_t *startReadyComponents;
+    uint16_t numStartReadyComponents;
+    bool isInlineAction;
+    uint16_t numPooledFlowStates;
+    void *pooledFlowStates;
+};
+struct ComponentInputCounters {
+    uint16_t numEmptyMandatoryInputs;
+    uint16_t numNonEmptySeqInputs;
+};
+void buildFlowMetadataIndex(Assets *assets);
+void freeFlowMetadataIndex(Assets *assets);
+struct FlowMetadataIndex {
+    Assets *assets;
+    FlowMetadata **flows;
+    unsigned numFlows;
+};
+FlowMetadata *getFlowMetadata(Assets *assets, int flowIndex);
+#if !defined(EEZ_FLOW_PARALLEL_ACTIONS)
+#define EEZ_FLOW_PARALLEL_ACTIONS 0
+#endif
+#if EEZ_FLOW_PARALLEL_ACTIONS
+struct ParallelActionJob;
+#endif
 struct FlowState {
 	uint32_t flowStateIndex;
 	Assets *assets;
 	FlowDefinition *flowDefinition;
 	Flow *flow;
+    FlowMetadata *flowMetadata;
 	uint16_t flowIndex;
 	bool isAction;
 	bool error;
     uint32_t refCounter;
+    uint32_t numBusyChildren;
     FlowState *parentFlowState;
 	Component *parentComponent;
 	int parentComponentIndex;
     Value inputValue;
     Value *values;
 	ComponenentExecutionState **componenentExecutionStates;
+    uint32_t *componentQueueCounts;
+    ComponentInputCounters *componentInputCounters;
     bool *componenentAsyncStates;
     unsigned executingComponentIndex;
     float timelinePosition;
 #if defined(EEZ_FOR_LVGL)
     int32_t lvglWidgetStartIndex;
 #endif
+#if EEZ_FLOW_PARALLEL_ACTIONS
+    ParallelActionJob *parallelActionJob;
+#endif
+    uint32_t traceId;
     Value eventValue;
     FlowState *firstChild;
     FlowState *lastChild;
     FlowState *previousSibling;
     FlowState *nextSibling;
 };
-extern int g_selectedLanguage;
-extern FlowState *g_firstFlowState;
-extern FlowState *g_lastFlowState;
-FlowState *initActionFlowState(int flowIndex, FlowState *parentFlowState, int parentComponentIndex, const Value &value);
+FlowState *initFlowState(Assets *assets, int flowIndex, FlowState *parentFlowState, int parentComponentIndex, const Value &inputValue, bool pingStartComponents = true);
+FlowState *initActionFlowState(int flowIndex, FlowState *parentFlowState, int parentComponentIndex, const Value &value, bool pingStartComponents = true);
+bool isInlineActionFlow(Assets *assets, int flowIndex);
+void executeInlineActionFlowState(FlowState *flowState);
 FlowState *initPageFlowState(Assets *assets, int flowIndex, FlowState *parentFlowState, int parentComponentIndex);
+#if EEZ_FLOW_PARALLEL_ACTIONS
+FlowState *initParallelActionProxyFlowState(Assets *assets, int flowIndex, ParallelActionJob *job);
+#endif
 void incRefCounterForFlowState(FlowState *flowState);
 void decRefCounterForFlowState(FlowState *flowState);
 bool canFreeFlowState(FlowState *flowState);
@@ -2325,12 +2459,11 @@ void getValue(uint16_t dataId, DataOperationEnum operation, const WidgetCursor &
 void setValue(uint16_t dataId, const WidgetCursor &widgetCursor, const Value& value);
 #endif
 void assignValue(FlowState *flowState, int componentIndex, Value &dstValue, const Value &srcValue);
+void setInputValue(FlowState *flowState, unsigned inputIndex, const Value &value);
 void clearInputValue(FlowState *flowState, int inputIndex);
 void startAsyncExecution(FlowState *flowState, int componentIndex);
 void endAsyncExecution(FlowState *flowState, int componentIndex);
 void executeCallAction(FlowState *flowState, unsigned componentIndex, int flowIndex, const Value& value);
-extern FlowState *g_executeActionFlowState;
-extern unsigned g_executeActionComponentIndex;
 enum FlowEvent {
     FLOW_EVENT_OPEN_PAGE,
     FLOW_EVENT_CLOSE_PAGE,
@@ -2363,9 +2496,12 @@ namespace date {
 enum DstRule { DST_RULE_OFF, DST_RULE_EUROPE, DST_RULE_USA, DST_RULE_AUSTRALIA };
 enum Format { FORMAT_DMY_24, FORMAT_MDY_24, FORMAT_DMY_12, FORMAT_MDY_12 };
 typedef uint64_t Date;
-extern Format g_localeFormat;
-extern int g_timeZone;
-extern DstRule g_dstRule;
+Format getLocaleFormat();
+void setLocaleFormat(Format format);
+int getTimeZone();
+void setTimeZone(int timeZone);
+DstRule getDstRule();
+void setDstRule(DstRule dstRule);
 Date now();
 void toString(Date time, char *str, uint32_t strLen);
 void toLocaleString(Date time, char *str, uint32_t strLen);
@@ -2389,15 +2525,21 @@ Date localToUtc(Date local);
 // -----------------------------------------------------------------------------
 namespace eez {
 namespace flow {
-extern bool g_debuggerIsConnected;
 enum {
     DEBUGGER_MODE_RUN,
     DEBUGGER_MODE_DEBUG,
 };
-extern int g_debuggerMode;
+enum DebuggerState {
+    DEBUGGER_STATE_RESUMED,
+    DEBUGGER_STATE_PAUSED,
+    DEBUGGER_STATE_SINGLE_STEP,
+    DEBUGGER_STATE_STOPPED,
+};
 bool canExecuteStep(FlowState *&flowState, unsigned &componentIndex);
 void onStarted(Assets *assets);
 void onStopped();
+bool isDebuggerTrackingQueue();
+void onQueueStats();
 void onAddToQueue(FlowState *flowState, int sourceComponentIndex, int sourceOutputIndex, unsigned targetComponentIndex, int targetInputIndex);
 void onRemoveFromQueue();
 void onValueChanged(const Value *pValue);
@@ -2488,6 +2630,31 @@ extern uint32_t g_wasmModuleId;
 struct FlowState;
 unsigned start(Assets *assets);
 void tick();
+static const uint32_t NO_WAKEUP = 0xFFFFFFFF;
+static const uint32_t FLOW_TICK_MAX_DURATION_MS = 5;
+uint32_t getNextWakeup();
+static const uint32_t TICK_OVERRUN_NUM_BUCKETS = 8;
+static const uint32_t TICK_OVERRUN_MAX_COMPONENT_TYPES = 16;
+extern const uint32_t TICK_OVERRUN_BUCKET_LIMITS_US[TICK_OVERRUN_NUM_BUCKETS - 1];
+struct TickOverrunComponentStats {
+    uint16_t componentType;
+    uint32_t numOverruns;
+    uint32_t maxOverrunUs;
+};
+struct TickOverrunStats {
+    uint32_t numTicks;
+    uint32_t numOverruns;
+    uint32_t maxOverrunUs;
+    uint32_t averageComponentCostUs;
+    uint32_t histogram[TICK_OVERRUN_NUM_BUCKETS];
+    TickOverrunComponentStats components[TICK_OVERRUN_MAX_COMPONENT_TYPES];
+    uint32_t numComponentTypes;
+    uint32_t numOtherComponentOverruns;
+};
+void setTickBudget(uint32_t microseconds);
+uint32_t getTickBudget();
+const TickOverrunStats &getTickOverrunStats();
+void resetTickOverrunStats();
 void stop();
 bool isFlowStopped();
 #if EEZ_OPTION_GUI
@@ -2552,12 +2719,38 @@ extern void (*onFlowErrorHook)(FlowState *flowState, int componentIndex, const c
 } 
 } 
 // -----------------------------------------------------------------------------
+// flow/json.h
+// -----------------------------------------------------------------------------
+#if !defined(EEZ_DASHBOARD_API)
+#ifndef EEZ_FLOW_JSON_LOOKUP_CACHE_SIZE
+#define EEZ_FLOW_JSON_LOOKUP_CACHE_SIZE 32
+#endif
+#ifndef EEZ_FLOW_JSON_MAX_DEPTH
+#define EEZ_FLOW_JSON_MAX_DEPTH 32
+#endif
+namespace eez {
+namespace flow {
+struct JsonDocument;
+struct JsonRef : public Ref {
+    ~JsonRef();
+    JsonDocument *document;
+    uint32_t node;
+};
+Value jsonParse(const char *text, int len, uint32_t id);
+Value jsonGet(const Value &jsonValue, const Value &property);
+int jsonArrayLength(const Value &jsonValue);
+void jsonValueToText(const Value &jsonValue, char *text, int count);
+} 
+} 
+#endif
+// -----------------------------------------------------------------------------
 // flow/operations.h
 // -----------------------------------------------------------------------------
 namespace eez {
 namespace flow {
 typedef void (*EvalOperation)(EvalStack &);
 extern EvalOperation g_evalOperations[];
+bool isPureOperation(uint16_t operation);
 Value op_add(const Value& a1, const Value& b1);
 Value op_sub(const Value& a1, const Value& b1);
 Value op_mul(const Value& a1, const Value& b1);
@@ -2581,10 +2774,68 @@ Value op_great_eq(const Value& a1, const Value& b1);
 // -----------------------------------------------------------------------------
 namespace eez {
 namespace flow {
+#if !defined(EEZ_FLOW_QUEUE_SIZE)
+#define EEZ_FLOW_QUEUE_SIZE 1000
+#endif
+#if !defined(EEZ_FLOW_QUEUE_CHUNK_SIZE)
+#define EEZ_FLOW_QUEUE_CHUNK_SIZE 64
+#endif
+static const unsigned QUEUE_SIZE = EEZ_FLOW_QUEUE_SIZE;
+static const unsigned QUEUE_CHUNK_SIZE = EEZ_FLOW_QUEUE_CHUNK_SIZE;
+static const unsigned QUEUE_NUM_STATIC_CHUNKS = (QUEUE_SIZE + QUEUE_CHUNK_SIZE - 1) / QUEUE_CHUNK_SIZE;
+struct QueueTask {
+	FlowState *flowState;
+	unsigned componentIndex;
+    bool continuousTask;
+};
+struct QueueChunk {
+    QueueChunk *next;
+    QueueTask tasks[QUEUE_CHUNK_SIZE];
+};
+struct QueueLaneState {
+    QueueChunk *headChunk;
+    unsigned headIndex;
+    QueueChunk *tailChunk;
+    unsigned tailIndex;
+    size_t size;
+    size_t numNonContinuousTasks;
+    size_t numContinuousVisits;
+};
+struct InlineActionQueue {
+    FlowState *flowState;
+    unsigned head;
+    unsigned tail;
+    uint16_t componentIndexes[EEZ_FLOW_INLINE_ACTION_MAX_TASKS];
+};
 void queueReset();
 size_t getQueueSize();
 size_t getMaxQueueSize();
-extern unsigned g_numContinuousTaskInQueue;
+struct QueueStats {
+    uint32_t size;
+    uint32_t capacity;
+    uint32_t highWaterMark;
+    float averageDepth;
+    uint32_t overflowsAvoided;
+    uint32_t chunkAllocations;
+    uint32_t chunkFrees;
+};
+void getQueueStats(QueueStats &stats);
+void queueSampleDepth();
+enum QueueLane {
+    QUEUE_LANE_UI,
+    QUEUE_LANE_NORMAL,
+    QUEUE_LANE_BACKGROUND,
+    QUEUE_NUM_LANES,
+    QUEUE_LANE_INHERIT = 0xFF
+};
+struct QueueLaneScope {
+    QueueLane savedLane;
+    QueueLaneScope(QueueLane lane);
+    ~QueueLaneScope();
+};
+void setFlowQueueLane(unsigned flowIndex, QueueLane lane);
+QueueLane getNextTaskQueueLane();
+void resetQueueLaneVisits();
 bool addToQueue(FlowState *flowState, unsigned componentIndex,
     int sourceComponentIndex, int sourceOutputIndex, int targetInputIndex,
     bool continuousTask);
@@ -2594,18 +2845,411 @@ bool isInQueue(FlowState *flowState, unsigned componentIndex);
 } 
 } 
 // -----------------------------------------------------------------------------
+// flow/timer_wheel.h
+// -----------------------------------------------------------------------------
+namespace eez {
+namespace flow {
+static const unsigned TIMER_WHEEL_LEVELS = 4;
+static const unsigned TIMER_WHEEL_SLOT_BITS = 6;
+static const unsigned TIMER_WHEEL_SLOTS = 1 << TIMER_WHEEL_SLOT_BITS;
+struct TimerWheelNode {
+    FlowState *flowState;
+    unsigned componentIndex;
+    uint32_t deadline;
+    TimerWheelNode **slot;
+    TimerWheelNode *prev;
+    TimerWheelNode *next;
+    TimerWheelNode() : slot(nullptr) {}
+};
+void timerWheelSchedule(TimerWheelNode *node, FlowState *flowState, unsigned componentIndex, uint32_t deadline);
+void timerWheelCancel(TimerWheelNode *node);
+inline bool timerWheelIsScheduled(const TimerWheelNode *node) { return node->slot != nullptr; }
+void visitTimerWheel(uint32_t now);
+bool timerWheelGetNextDeadline(uint32_t &deadline);
+size_t getTimerWheelSize();
+void timerWheelReset();
+} 
+} 
+// -----------------------------------------------------------------------------
 // flow/watch_list.h
 // -----------------------------------------------------------------------------
 namespace eez {
 namespace flow {
 struct WatchListNode;
+struct WatchList {
+    WatchListNode *first;
+    WatchListNode *last;
+};
 WatchListNode *watchListAdd(FlowState *flowState, unsigned componentIndex);
 void watchListRemove(WatchListNode *node);
 void visitWatchList();
+bool isWatchListEmpty();
 void watchListReset();
 } 
 } 
 // -----------------------------------------------------------------------------
+// flow/runtime.h
+// -----------------------------------------------------------------------------
+#if !defined(EEZ_FLOW_RUNTIME_THREAD_LOCAL)
+#if !defined(__EMSCRIPTEN__) && (defined(__linux__) || defined(__APPLE__) || defined(_WIN32))
+#define EEZ_FLOW_RUNTIME_THREAD_LOCAL 1
+#else
+#define EEZ_FLOW_RUNTIME_THREAD_LOCAL 0
+#endif
+#endif
+#if EEZ_FLOW_RUNTIME_THREAD_LOCAL
+#define EEZ_FLOW_RUNTIME_STORAGE thread_local
+#else
+#define EEZ_FLOW_RUNTIME_STORAGE
+#endif
+#if !defined(EEZ_FLOW_THREAD_SAFE_ALLOC)
+#define EEZ_FLOW_THREAD_SAFE_ALLOC EEZ_FLOW_PARALLEL_ACTIONS
+#endif
+#if EEZ_FLOW_PARALLEL_ACTIONS && !EEZ_FLOW_THREAD_SAFE_ALLOC
+#error EEZ_FLOW_PARALLEL_ACTIONS requires EEZ_FLOW_THREAD_SAFE_ALLOC
+#endif
+#if !defined(EEZ_LVGL_SCREEN_STACK_SIZE)
+#define EEZ_LVGL_SCREEN_STACK_SIZE 10
+#endif
+namespace eez {
+namespace flow {
+struct SortArrayActionComponent;
+struct MQTTConnection;
+#if EEZ_FLOW_PARALLEL_ACTIONS
+struct ParallelActionInfo;
+#endif
+struct TraceRecorder;
+struct TraceReplayer;
+struct Runtime {
+    bool isMainAssetsLoaded = false;
+    Assets *mainAssets = nullptr;
+    bool mainAssetsUncompressed = false;
+    AssetsSections *mainAssetsSections = nullptr;
+    Assets *externalAssets = nullptr;
+    GlobalVariables *globalVariables = nullptr;
+    FlowMetadataIndex mainFlowMetadataIndex = {};
+    FlowMetadataIndex externalFlowMetadataIndex = {};
+    AssetsNameIndex mainAssetsNameIndex = {};
+    AssetsNameIndex externalAssetsNameIndex = {};
+    FlowState *firstFlowState = nullptr;
+    FlowState *lastFlowState = nullptr;
+    bool isStopping = false;
+    bool isStopped = true;
+    int selectedLanguage = 0;
+    bool enableThrowError = true;
+    FlowState *executeActionFlowState = nullptr;
+    unsigned executeActionComponentIndex = 0;
+    SortArrayActionComponent *sortArrayActionComponent = nullptr;
+    EvalStack stack;
+    uint32_t tickBudgetUs = FLOW_TICK_MAX_DURATION_MS * 1000;
+    uint32_t componentCostUsQ4 = 0;
+    TickOverrunStats tickOverrunStats = {};
+    QueueChunk *staticChunks;
+    unsigned numStaticChunks;
+    QueueChunk *freeStaticChunks = nullptr;
+    QueueChunk *spareChunk = nullptr;
+    QueueLaneState lanes[QUEUE_NUM_LANES] = {};
+    size_t queueSize = 0;
+    size_t queueCapacity = 0;
+    unsigned queueMax = 0;
+    uint64_t queueDepthSum = 0;
+    uint32_t queueDepthSamples = 0;
+    uint32_t queueOverflowsAvoided = 0;
+    uint32_t queueChunkAllocations = 0;
+    uint32_t queueChunkFrees = 0;
+    uint8_t *flowQueueLanes = nullptr;
+    unsigned numFlowQueueLanes = 0;
+    unsigned numContinuousTaskInQueue = 0;
+    QueueLane currentQueueLane = QUEUE_LANE_NORMAL;
+    InlineActionQueue *inlineActionQueue = nullptr;
+    TimerWheelNode *timerWheel[TIMER_WHEEL_LEVELS][TIMER_WHEEL_SLOTS] = {};
+    unsigned timerWheelLevelSize[TIMER_WHEEL_LEVELS] = {};
+    uint32_t timerWheelTime = 0;
+    size_t timerWheelSize = 0;
+    WatchList watchList = {};
+    bool debuggerIsConnected = false;
+    uint32_t messageSubsciptionFilter = 0xFFFFFFFF;
+    DebuggerState debuggerState = DEBUGGER_STATE_RESUMED;
+    bool skipNextBreakpoint = false;
+    char inputFromDebugger[64] = {};
+    unsigned inputFromDebuggerPosition = 0;
+    int debuggerMode = DEBUGGER_MODE_RUN;
+    QueueStats lastQueueStats = {};
+    uint8_t traceMode = 0;
+    bool traceInEngine = false;
+    uint32_t numTracedFlowStates = 0;
+    TraceRecorder *traceRecorder = nullptr;
+    TraceReplayer *traceReplayer = nullptr;
+    unsigned assetsDecompressionThreads = EEZ_ASSETS_DECOMPRESSION_THREADS;
+    date::Format dateLocaleFormat = date::FORMAT_DMY_24;
+    int dateTimeZone = 0;
+    date::DstRule dateDstRule = date::DST_RULE_OFF;
+    MQTTConnection *firstMQTTConnection = nullptr;
+    MQTTConnection *lastMQTTConnection = nullptr;
+#if defined(EEZ_FOR_LVGL)
+    int16_t currentScreen = -1;
+    int16_t screenStack[EEZ_LVGL_SCREEN_STACK_SIZE] = {};
+    unsigned screenStackPosition = 0;
+#endif
+#if EEZ_FLOW_PARALLEL_ACTIONS
+    bool isParallelActionWorker = false;
+    unsigned numParallelActionsInFlight = 0;
+    Assets *parallelActionInfosAssets = nullptr;
+    ParallelActionInfo *parallelActionInfos = nullptr;
+    unsigned numParallelActionInfos = 0;
+#endif
+    Runtime(QueueChunk *staticChunks_ = nullptr, unsigned numStaticChunks_ = 0) : staticChunks(staticChunks_), numStaticChunks(numStaticChunks_) {}
+};
+extern EEZ_FLOW_RUNTIME_STORAGE Runtime *g_runtime;
+Runtime *getDefaultRuntime();
+Runtime *createRuntime();
+void destroyRuntime(Runtime *runtime);
+Runtime *setCurrentRuntime(Runtime *runtime);
+struct RuntimeScope {
+    Runtime *savedRuntime;
+    RuntimeScope(Runtime *runtime) : savedRuntime(g_runtime) { g_runtime = runtime; }
+    ~RuntimeScope() { g_runtime = savedRuntime; }
+};
+void loadMainAssets(Runtime *runtime, const uint8_t *assets, uint32_t assetsSize);
+unsigned start(Runtime *runtime);
+void tick(Runtime *runtime);
+void stop(Runtime *runtime);
+} 
+} 
+// -----------------------------------------------------------------------------
+// flow/parallel.h
+// -----------------------------------------------------------------------------
+#if EEZ_FLOW_PARALLEL_ACTIONS && defined(__EMSCRIPTEN__)
+#error EEZ_FLOW_PARALLEL_ACTIONS is not supported on Emscripten
+#endif
+namespace eez {
+namespace flow {
+#if EEZ_FLOW_PARALLEL_ACTIONS
+void setParallelActionWorkers(unsigned numWorkers);
+unsigned getParallelActionWorkers();
+bool dispatchParallelAction(FlowState *flowState, unsigned componentIndex, int flowIndex);
+void visitParallelActions();
+void cancelParallelActions();
+void onParallelActionOutput(FlowState *flowState, unsigned outputIndex, const Value &value);
+bool onParallelActionError(FlowState *flowState, const char *errorMessage);
+#endif
+} 
+} 
+// -----------------------------------------------------------------------------
+// flow/checkpoint.h
+// -----------------------------------------------------------------------------
+namespace eez {
+namespace flow {
+static const uint32_t CHECKPOINT_MAGIC = 0x435A4545;
+static const uint16_t CHECKPOINT_VERSION = 1;
+struct CheckpointWriter {
+    uint8_t *buffer;
+    size_t bufferSize;
+    size_t size;
+};
+struct CheckpointReader {
+    const uint8_t *data;
+    size_t size;
+    size_t offset;
+};
+void checkpointWrite(CheckpointWriter &writer, const void *data, size_t size);
+bool checkpointRead(CheckpointReader &reader, void *data, size_t size);
+bool checkpointWriteValue(CheckpointWriter &writer, const Value &value);
+bool checkpointReadValue(CheckpointReader &reader, Value &value);
+bool saveCheckpoint(uint8_t *buffer, size_t bufferSize, size_t &checkpointSize);
+bool restoreCheckpoint(const uint8_t *data, size_t size);
+uint32_t getFlowDefinitionHash(FlowDefinition *flowDefinition);
+bool saveCatchErrorComponentExecutionState(CheckpointWriter &writer, FlowState *flowState, unsigned componentIndex);
+bool restoreCatchErrorComponentExecutionState(CheckpointReader &reader, FlowState *flowState, unsigned componentIndex);
+bool saveCounterComponentExecutionState(CheckpointWriter &writer, FlowState *flowState, unsigned componentIndex);
+bool restoreCounterComponentExecutionState(CheckpointReader &reader, FlowState *flowState, unsigned componentIndex);
+bool saveDelayComponentExecutionState(CheckpointWriter &writer, FlowState *flowState, unsigned componentIndex);
+bool restoreDelayComponentExecutionState(CheckpointReader &reader, FlowState *flowState, unsigned componentIndex);
+} 
+} 
+// -----------------------------------------------------------------------------
+// flow/trace.h
+// -----------------------------------------------------------------------------
+#if !defined(EEZ_FLOW_TRACE_BUFFER_SIZE)
+#define EEZ_FLOW_TRACE_BUFFER_SIZE 256
+#endif
+namespace eez {
+namespace flow {
+static const uint32_t TRACE_MAGIC = 0x54524545;
+static const uint16_t TRACE_VERSION = 1;
+enum TraceMode {
+    TRACE_MODE_OFF,
+    TRACE_MODE_RECORD,
+    TRACE_MODE_REPLAY
+};
+enum TraceEvent {
+    TRACE_EVENT_START = 1,
+    TRACE_EVENT_TICK,
+    TRACE_EVENT_MILLIS,
+    TRACE_EVENT_MICROS,
+    TRACE_EVENT_DATE_NOW,
+    TRACE_EVENT_NATIVE_VARIABLE,
+    TRACE_EVENT_ACTION_BEGIN,
+    TRACE_EVENT_ACTION_END,
+    TRACE_EVENT_PAGE,
+    TRACE_EVENT_USER_WIDGET,
+    TRACE_EVENT_PROPAGATE_VALUE,
+    TRACE_EVENT_ADD_TO_QUEUE,
+    TRACE_EVENT_SET_GLOBAL_VARIABLE,
+    TRACE_EVENT_SET_USER_PROPERTY,
+    TRACE_EVENT_STOP
+};
+enum TraceReplayResult {
+    TRACE_REPLAY_TICK,
+    TRACE_REPLAY_END,
+    TRACE_REPLAY_DIVERGED
+};
+typedef void (*TraceWriteHook)(const uint8_t *data, uint32_t size, void *context);
+struct TraceStats {
+    uint64_t size;
+    uint32_t numEvents;
+    uint32_t numUnsupportedValues;
+};
+struct TraceEngineScope {
+    bool savedTraceInEngine;
+    TraceEngineScope(bool traceInEngine) : savedTraceInEngine(g_runtime->traceInEngine) { g_runtime->traceInEngine = traceInEngine; }
+    ~TraceEngineScope() { g_runtime->traceInEngine = savedTraceInEngine; }
+};
+inline bool isTracingExternalCall() {
+    return g_runtime->traceMode == TRACE_MODE_RECORD && !g_runtime->traceInEngine;
+}
+bool startTraceRecording(TraceWriteHook writeHook, void *context);
+void stopTraceRecording();
+bool getTraceStats(TraceStats &stats);
+bool startTraceReplay(const uint8_t *trace, size_t traceSize);
+TraceReplayResult replayTraceStep();
+void stopTraceReplay();
+void traceStart(Assets *assets);
+void recordTraceTick();
+uint32_t traceClock(TraceEvent event, uint32_t (*readClock)());
+double traceDateNow(double (*readDateNow)());
+Value traceNativeVariable(int16_t id, Value (*readNativeVariable)(int16_t id));
+void traceActionFunction(int actionId, void (*executeAction)(int actionId));
+void recordTracePage(Assets *assets, int flowIndex);
+void recordTraceUserWidget(FlowState *flowState, unsigned componentIndex);
+void recordTracePropagateValue(FlowState *flowState, unsigned componentIndex, unsigned outputIndex, const Value &value);
+void recordTraceAddToQueue(FlowState *flowState, unsigned componentIndex, int sourceComponentIndex, int sourceOutputIndex, int targetInputIndex, bool continuousTask);
+void recordTraceSetGlobalVariable(Assets *assets, uint32_t globalVariableIndex, const Value &value);
+void recordTraceSetUserProperty(unsigned propertyIndex, const Value &value);
+void recordTraceStop();
+} 
+} 
+// -----------------------------------------------------------------------------
+// flow/coroutine.h
+// -----------------------------------------------------------------------------
+#if !defined(EEZ_FLOW_COROUTINES)
+#define EEZ_FLOW_COROUTINES 0
+#endif
+#if EEZ_FLOW_COROUTINES && !(defined(__cpp_impl_coroutine) && __cpp_impl_coroutine >= 201902L)
+#error EEZ_FLOW_COROUTINES requires a C++20 compiler with coroutine support
+#endif
+#if EEZ_FLOW_COROUTINES
+#include <coroutine>
+namespace eez {
+namespace flow {
+enum ComponentCoroutineWait {
+    COMPONENT_COROUTINE_WAIT_NONE,
+    COMPONENT_COROUTINE_WAIT_TIMER,
+    COMPONENT_COROUTINE_WAIT_SIGNAL,
+    COMPONENT_COROUTINE_WAIT_INPUT,
+    COMPONENT_COROUTINE_WAIT_READY
+};
+struct ComponentCoroutine {
+    struct promise_type {
+        FlowState *flowState;
+        unsigned componentIndex;
+        template <typename... Args>
+        promise_type(FlowState *flowState_, unsigned componentIndex_, Args &&...) : flowState(flowState_), componentIndex(componentIndex_) {}
+        static void *operator new(size_t size) noexcept { return alloc(size, 0x3c5e9a71); }
+        static void operator delete(void *ptr) { free(ptr); }
+        static ComponentCoroutine get_return_object_on_allocation_failure() { return ComponentCoroutine(nullptr); }
+        ComponentCoroutine get_return_object() { return ComponentCoroutine(std::coroutine_handle<promise_type>::from_promise(*this)); }
+        std::suspend_always initial_suspend() noexcept { return {}; }
+        std::suspend_always final_suspend() noexcept { return {}; }
+        void return_void() {}
+        void unhandled_exception() {}
+    };
+    std::coroutine_handle<promise_type> handle;
+    explicit ComponentCoroutine(std::coroutine_handle<promise_type> handle_) : handle(handle_) {}
+    ComponentCoroutine(std::nullptr_t) : handle(nullptr) {}
+};
+typedef std::coroutine_handle<ComponentCoroutine::promise_type> ComponentCoroutineHandle;
+struct ComponentCoroutineExecutionState : public ComponenentExecutionState {
+    ComponentCoroutineHandle handle;
+    TimerWheelNode timer;
+    ComponentCoroutineWait wait;
+    bool signaled;
+    ComponentCoroutineExecutionState() : handle(nullptr), wait(COMPONENT_COROUTINE_WAIT_NONE), signaled(false) {}
+    virtual ~ComponentCoroutineExecutionState() override;
+};
+inline ComponentCoroutineExecutionState *getComponentCoroutineExecutionState(ComponentCoroutineHandle handle) {
+    auto &promise = handle.promise();
+    return (ComponentCoroutineExecutionState *)promise.flowState->componenentExecutionStates[promise.componentIndex];
+}
+struct ComponentCoroutineSleep {
+    uint32_t deadline;
+    bool await_ready() const { return false; }
+    void await_suspend(ComponentCoroutineHandle handle) {
+        auto &promise = handle.promise();
+        auto state = getComponentCoroutineExecutionState(handle);
+        state->wait = COMPONENT_COROUTINE_WAIT_TIMER;
+        timerWheelSchedule(&state->timer, promise.flowState, promise.componentIndex, deadline);
+    }
+    void await_resume() {}
+};
+struct ComponentCoroutineSignal {
+    bool await_ready() const { return false; }
+    bool await_suspend(ComponentCoroutineHandle handle) {
+        auto state = getComponentCoroutineExecutionState(handle);
+        if (state->signaled) {
+            state->signaled = false;
+            return false;
+        }
+        state->wait = COMPONENT_COROUTINE_WAIT_SIGNAL;
+        incRefCounterForFlowState(handle.promise().flowState);
+        return true;
+    }
+    void await_resume() {}
+};
+struct ComponentCoroutineInput {
+    bool yield;
+    bool await_ready() const { return false; }
+    void await_suspend(ComponentCoroutineHandle handle) {
+        auto &promise = handle.promise();
+        getComponentCoroutineExecutionState(handle)->wait = COMPONENT_COROUTINE_WAIT_INPUT;
+        if (yield) {
+            addToQueue(promise.flowState, promise.componentIndex, -1, -1, -1, false);
+        }
+    }
+    void await_resume() {}
+};
+inline ComponentCoroutineSleep sleepUntil(uint32_t deadline) { return { deadline }; }
+inline ComponentCoroutineSleep sleepFor(uint32_t milliseconds) { return { millis() + milliseconds }; }
+inline ComponentCoroutineSignal waitForSignal() { return {}; }
+inline ComponentCoroutineInput waitForInput() { return { false }; }
+inline ComponentCoroutineInput yieldToScheduler() { return { true }; }
+void runComponentCoroutine(FlowState *flowState, unsigned componentIndex, ComponentCoroutineExecutionState *state);
+template <typename T = ComponentCoroutineExecutionState>
+void startComponentCoroutine(FlowState *flowState, unsigned componentIndex, ComponentCoroutine coroutine) {
+    if (!coroutine.handle) {
+        throwError(flowState, componentIndex, "Out of memory\n");
+        return;
+    }
+    auto state = allocateComponentExecutionState<T>(flowState, componentIndex);
+    state->handle = coroutine.handle;
+    runComponentCoroutine(flowState, componentIndex, state);
+}
+void resumeComponentCoroutine(FlowState *flowState, unsigned componentIndex);
+void signalComponentCoroutine(ComponentCoroutineExecutionState *state);
+} 
+} 
+#endif
+// -----------------------------------------------------------------------------
 // flow/components/call_action.h
 // -----------------------------------------------------------------------------
 namespace eez {
@@ -2871,8 +3515,46 @@ void eez_flow_init_styles(
     void (*remove_style)(lv_obj_t *obj, int32_t styleIndex)
 );
 void eez_flow_tick();
+uint32_t eez_flow_get_next_wakeup();
+typedef struct {
+    uint32_t size;
+    uint32_t capacity;
+    uint32_t high_water_mark;
+    float average_depth;
+    uint32_t overflows_avoided;
+    uint32_t chunk_allocations;
+    uint32_t chunk_frees;
+} eez_flow_queue_stats_t;
+void eez_flow_get_queue_stats(eez_flow_queue_stats_t *stats);
+void eez_flow_set_flow_queue_lane(unsigned flowIndex, int lane);
+void eez_flow_set_tick_budget_us(uint32_t microseconds);
+typedef struct {
+    uint32_t num_ticks;
+    uint32_t num_overruns;
+    uint32_t max_overrun_us;
+    uint32_t average_component_cost_us;
+    uint32_t histogram[8];
+    uint16_t component_types[16];
+    uint32_t component_overruns[16];
+    uint32_t num_component_types;
+    uint32_t other_component_overruns;
+} eez_flow_tick_overrun_stats_t;
+void eez_flow_get_tick_overrun_stats(eez_flow_tick_overrun_stats_t *stats);
 bool eez_flow_is_stopped();
-extern int16_t g_currentScreen;
+void *eez_flow_runtime_create();
+void eez_flow_runtime_destroy(void *runtime);
+void *eez_flow_runtime_set_current(void *runtime);
+bool eez_flow_checkpoint_save(uint8_t *buffer, uint32_t buffer_size, uint32_t *checkpoint_size);
+bool eez_flow_checkpoint_restore(const uint8_t *checkpoint, uint32_t checkpoint_size);
+typedef void (*eez_flow_trace_write_func_t)(const uint8_t *data, uint32_t size, void *context);
+bool eez_flow_trace_record_start(eez_flow_trace_write_func_t write_func, void *context);
+void eez_flow_trace_record_stop();
+bool eez_flow_trace_replay_start(const uint8_t *trace, uint32_t trace_size);
+int eez_flow_trace_replay_step();
+void eez_flow_trace_replay_stop();
+#if EEZ_FLOW_PARALLEL_ACTIONS
+void eez_flow_set_parallel_action_workers(unsigned num_workers);
+#endif
 int16_t eez_flow_get_current_screen();
 void eez_flow_set_screen(int16_t screenId, lv_scr_load_anim_t animType, uint32_t speed, uint32_t delay);
 void eez_flow_push_screen(int16_t screenId, lv_scr_load_anim_t animType, uint32_t speed, uint32_t delay);
@@ -3028,7 +3710,7 @@ extern "C" {
 #define utf8_constexpr14_impl
 #endif
 
-#if !defined(RENESAS) && !defined(ESP32) && !defined(ESP_PLATFORM) && defined(__cplusplus) && __cplusplus >= 202002L
+#if !defined(RENESAS) && !defined(ESP32) && !defined(ESP_PLATFORM) && defined(UTF8_USE_CHAR8_T) && defined(__cplusplus) && __cplusplus >= 202002L
 using utf8_int8_t = char8_t; /* Introduced in C++20 */
 #else
 typedef char utf8_int8_t;
@@ -432,6 +432,7 @@ async function buildEezH(files: Map<string, string>, autogenComment: string) {
 #define EEZ_FOR_LVGL_SHA256_OPTION 1
 #define EEZ_FLOW_QUEUE_SIZE 1000
 #define EEZ_FLOW_EVAL_STACK_SIZE 20
+#define EEZ_ASSETS_PARALLEL_DECOMPRESSION 0
 `;
 
     for (const filePath of CONFIG.headersFront) {
@@ -0,0 +1,43 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "eez-flow.h"
+
+static int g_failures;
+
+static void check(const char *what, size_t offset, size_t size, uint32_t actual, uint32_t expected) {
+    if (actual != expected) {
+        printf("FAIL %s offset=%u size=%u: %08x != %08x\n", what, (unsigned)offset, (unsigned)size, (unsigned)actual, (unsigned)expected);
+        g_failures++;
+    }
+}
+
+static void crossCheck(const char *what, const uint8_t *buffer, size_t bufferSize) {
+    for (size_t offset = 0; offset <= 8; offset++) {
+        for (size_t size = 0; size <= 600 && offset + size <= bufferSize; size++) {
+            check(what, offset, size, eez::crc32(buffer + offset, size), eez::crc32Bitwise(buffer + offset, size));
+        }
+    }
+    check(what, 0, bufferSize, eez::crc32(buffer, bufferSize), eez::crc32Bitwise(buffer, bufferSize));
+    check(what, 0, 9, eez::crc32((const uint8_t *)"123456789", 9), 0xCBF43926);
+}
+
+int main() {
+    size_t bufferSize = 4 * 1024 * 1024;
+    auto buffer = (uint8_t *)malloc(bufferSize);
+    uint32_t seed = 1;
+    for (size_t i = 0; i < bufferSize; i++) {
+        seed = seed * 1103515245 + 12345;
+        buffer[i] = (uint8_t)(seed >> 16);
+    }
+
+    crossCheck("default", buffer, bufferSize);
+    eez::crc32UsePortable(true);
+    crossCheck("portable", buffer, bufferSize);
+    eez::crc32UsePortable(false);
+
+    free(buffer);
+
+    printf("%s\n", g_failures ? "crc32: FAILED" : "crc32: OK");
+    return g_failures ? 1 : 0;
+}
@@ -0,0 +1,163 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <chrono>
+#include <mutex>
+#include <sstream>
+#include <string>
+
+// the flow definition is built in memory, so the asset lists must be writable
+#define private public
+#include "eez-flow.cpp"
+#undef private
+
+using namespace eez;
+using namespace eez::flow;
+
+// Page flow:   CallAction -> action flow
+// Action flow: MQTT Event (message output) -> counter component
+struct TestAssets {
+    Assets assets;
+    FlowDefinition flowDefinition;
+    AssetsPtr<Flow> flows[2];
+    Flow pageFlow;
+    Flow actionFlow;
+
+    AssetsPtr<Component> pageComponents[1];
+    CallActionActionComponent callAction;
+
+    AssetsPtr<Component> actionComponents[2];
+    MQTTEventActionComponenent mqttEvent;
+    Component counter;
+    uint16_t counterInputs[1];
+    ComponentInput actionFlowInputs[1];
+
+    AssetsPtr<ComponentOutput> mqttEventOutputs[2];
+    ComponentOutput outputs[2];
+    AssetsPtr<Connection> messageConnections[1];
+    Connection messageConnection;
+
+    AssetsPtr<Property> mqttEventProperties[1];
+    AssetsPtr<Value> constants[3];
+    Value constantValues[3];
+};
+
+static TestAssets g_testAssets;
+
+// PUSH_CONSTANT 2, END
+static const uint8_t g_connectionProperty[4] = { 0x02, 0x00, 0x00, 0xE0 };
+
+static int g_mqttHandle;
+static unsigned g_numDelivered;
+
+static void countDeliveredEvent(FlowState *, unsigned) {
+    g_numDelivered++;
+}
+
+static void buildAssets() {
+    auto &a = g_testAssets;
+
+    a.assets.flowDefinition = &a.flowDefinition;
+    a.flowDefinition.flows.count = 2;
+    a.flowDefinition.flows.items = a.flows;
+    a.flows[0] = &a.pageFlow;
+    a.flows[1] = &a.actionFlow;
+    for (unsigned i = 0; i < 3; i++) {
+        a.constants[i] = &a.constantValues[i];
+    }
+    a.flowDefinition.constants.count = 3;
+    a.flowDefinition.constants.items = a.constants;
+
+    a.pageFlow.components.count = 1;
+    a.pageFlow.components.items = a.pageComponents;
+    a.pageComponents[0] = &a.callAction;
+    a.callAction.type = defs_v3::COMPONENT_TYPE_CALL_ACTION_ACTION;
+    a.callAction.errorCatchOutput = -1;
+    a.callAction.flowIndex = 1;
+
+    a.actionFlow.components.count = 2;
+    a.actionFlow.components.items = a.actionComponents;
+    a.actionComponents[0] = &a.mqttEvent;
+    a.actionComponents[1] = &a.counter;
+    a.actionFlowInputs[0] = COMPONENT_INPUT_FLAG_IS_SEQ_INPUT;
+    a.actionFlow.componentInputs.count = 1;
+    a.actionFlow.componentInputs.items = a.actionFlowInputs;
+
+    a.mqttEvent.type = defs_v3::COMPONENT_TYPE_MQTT_EVENT_ACTION;
+    a.mqttEvent.errorCatchOutput = -1;
+    a.mqttEventProperties[0] = (Property *)g_connectionProperty;
+    a.mqttEvent.properties.count = 1;
+    a.mqttEvent.properties.items = a.mqttEventProperties;
+    a.mqttEventOutputs[0] = &a.outputs[0];
+    a.mqttEventOutputs[1] = &a.outputs[1];
+    a.mqttEvent.outputs.count = 2;
+    a.mqttEvent.outputs.items = a.mqttEventOutputs;
+    a.messageConnection.targetComponentIndex = 1;
+    a.messageConnection.targetInputIndex = 0;
+    a.messageConnections[0] = &a.messageConnection;
+    a.outputs[1].connections.count = 1;
+    a.outputs[1].connections.items = a.messageConnections;
+    a.mqttEvent.connectEventOutputIndex = -1;
+    a.mqttEvent.reconnectEventOutputIndex = -1;
+    a.mqttEvent.closeEventOutputIndex = -1;
+    a.mqttEvent.disconnectEventOutputIndex = -1;
+    a.mqttEvent.offlineEventOutputIndex = -1;
+    a.mqttEvent.endEventOutputIndex = -1;
+    a.mqttEvent.errorEventOutputIndex = -1;
+    a.mqttEvent.messageEventOutputIndex = 1;
+
+    a.counter.type = defs_v3::COMPONENT_TYPE_NOOP_ACTION;
+    a.counter.errorCatchOutput = -1;
+    a.counterInputs[0] = 0;
+    a.counter.inputs.count = 1;
+    a.counter.inputs.items = a.counterInputs;
+}
+
+static void runTicks() {
+    for (unsigned i = 0; i < 100; i++) {
+        lv_tick_inc(FLOW_TICK_MAX_DURATION_MS);
+        tick();
+    }
+}
+
+int main() {
+    lv_init();
+
+    buildAssets();
+    registerComponent(defs_v3::COMPONENT_TYPE_NOOP_ACTION, countDeliveredEvent);
+
+    g_runtime->mainAssets = &g_testAssets.assets;
+    start(&g_testAssets.assets);
+
+    addConnection(&g_mqttHandle);
+    Value connectionValue = Value::makeArrayRef(defs_v3::OBJECT_TYPE_MQTT_CONNECTION_NUM_FIELDS, defs_v3::OBJECT_TYPE_MQTT_CONNECTION, 0x5e0c1f01);
+    connectionValue.getArray()->values[defs_v3::OBJECT_TYPE_MQTT_CONNECTION_FIELD_ID] = Value(&g_mqttHandle, VALUE_TYPE_POINTER);
+    g_testAssets.constantValues[2] = connectionValue;
+
+    initPageFlowState(&g_testAssets.assets, 0, nullptr, 0);
+    runTicks();
+
+    EEZ_MQTT_MessageEvent message = { "topic", "payload" };
+    const unsigned NUM_EVENTS = 3;
+    for (unsigned i = 0; i < NUM_EVENTS; i++) {
+        eez::flow::eez_mqtt_on_event_callback(&g_mqttHandle, EEZ_MQTT_EVENT_MESSAGE, &message);
+        runTicks();
+    }
+
+    auto pageFlowState = g_runtime->firstFlowState;
+    bool actionFlowStateAlive = pageFlowState && pageFlowState->firstChild;
+
+    stop();
+    tick();
+
+    printf("mqtt event in action flow (coroutines %d): delivered %u of %u events, action flow state %s\n",
+        EEZ_FLOW_COROUTINES, g_numDelivered, NUM_EVENTS, actionFlowStateAlive ? "alive" : "freed");
+
+    if (g_numDelivered != NUM_EVENTS || !actionFlowStateAlive) {
+        printf("FAIL\n");
+        return 1;
+    }
+
+    printf("mqtt event in action flow: OK\n");
+    return 0;
+}